@@ -0,0 +1,1015 @@
+	/*
+		The game engine: the field, how it is generated, and the rules for changing it.
+		Everything here works on a field and settings alone, without any terminal I/O,
+		so the same engine drives the game, the solver and the benchmarks.
+	*/
+
+	/* Header File contains std headers, structs, other typedefs and function prototypes */
+		#include "minesweeper.h"
+
+	/* Standard Headers */
+		#include <stdlib.h>
+		#include <stdio.h>
+		#include <string.h>
+		#include <time.h>
+		#include <math.h>
+		#include <inttypes.h>
+		#ifdef __SSE2__
+			#include <immintrin.h>
+		#endif
+
+		#include <unistd.h>
+		#include <fcntl.h>
+		#include <errno.h>
+		#include <sys/mman.h>
+		#include <sys/stat.h>
+
+	/*Macros*/
+		#define FAILED(x) ((x) != EXIT_SUCCESS) // Macro for checking if a function call did not return EXIT_SUCCESS
+		#define MAX(x,y) ((x)>(y))?(x):(y) // Warning: Do not use with things with side-effects!
+		#define MIN(x,y) ((x)<(y))?(x):(y) // Warning: Do not use with things with side-effects!
+
+	/* A snapshot's tiles follow its header directly, so the header must keep them aligned */
+		_Static_assert(sizeof(snapshotheader) == 128 && sizeof(snapshotheader) % _Alignof(tile) == 0, "snapshotheader changed size");
+
+	/* Type Definitions */
+		SPECIALISED int setPointToAs(field Field, const settings* Settings, point Point, enum display Display, unsigned int options); /*
+			setPointTo(), following the ENGINE_OPTIONS in options rather than in Settings. */
+		SPECIALISED int checkWinAs(field Field, const settings* Settings, unsigned int options); // Likewise checkWin().
+		int setPointToInteractive(field Field, settings Settings, point Point, enum display Display); // For DEFAULT_INTERACTIVE
+		int checkWinInteractive(field Field, settings Settings);
+		int setPointToNotTty(field Field, settings Settings, point Point, enum display Display); // For DEFAULT_NOT_TTY
+		int checkWinNotTty(field Field, settings Settings);
+
+	/*Global Variables*/
+		_Thread_local FILE* err_file; // Where fatal() reports errors, per thread. Set by the front-end, else stderr.
+		const enginevariant InteractiveEngine = {setPointToInteractive, checkWinInteractive};
+		const enginevariant NotTtyEngine = {setPointToNotTty, checkWinNotTty};
+		const enginevariant GeneralEngine = {setPointTo, checkWin};
+
+	/*Methods*/
+
+	void fatal(const char* msg, int exitcode) {
+		fprintf(err_file ? err_file : stderr, "%s\n", msg);
+		exit(exitcode);
+	}
+
+	const char* engineError(int error) {
+		switch (error) {
+			case ENGINE_MINE: return "Revealed a mine";
+			case ENGINE_NO_MEMORY: return "Out of memory";
+			case ENGINE_OUT_OF_FIELD: return "Tried to access minepoint outside field!";
+			case ENGINE_UNCOVER: return "uncover-error"; // Matches what the SIMPLE_INPUT protocol expects
+			case ENGINE_BAD_FIELD: return "Found a mine during Zero Expansion, error in field!";
+			case ENGINE_BAD_STATE: return "Field state counters do not match the field!";
+			case ENGINE_TOO_DENSE: return "Could not lay out a no-guess field with that many mines";
+			case ENGINE_OVER_REVEALED: return "Too many squares revealed - some MUST be mines!";
+			default: return "Unknown error";
+		}
+	}
+
+	int createField(field* Field, settings Settings) {
+		if (!(*Field = calloc(1, sizeof(playfield)))) return EXIT_FAILURE;
+		(*Field)->fieldSize = Settings.fieldSize;
+		(*Field)->mines = Settings.mines;
+		(*Field)->ending = HIDDEN;
+		(*Field)->safe.x = (*Field)->safe.y = -1;
+		(*Field)->tileSlots = 8; // Grows as tiles are made, so fields that are never played stay small
+		if (!((*Field)->tiles = calloc((*Field)->tileSlots, sizeof(tile*)))) {
+			freeField(Field);
+			return EXIT_FAILURE;
+		}
+		(*Field)->State.hidden = (long long) Settings.fieldSize.x * Settings.fieldSize.y;
+		return EXIT_SUCCESS;
+	}
+
+	int freeField(field* Field) {
+		size_t i;
+		char* snapshot;
+		if (*Field && (*Field)->tiles) {
+			snapshot = (*Field)->snapshot;
+			for (i=0; i<(*Field)->tileSlots; i++) {
+				// Tiles loaded from a snapshot live in its mapping
+				if ((char*) (*Field)->tiles[i] < snapshot || (char*) (*Field)->tiles[i] >= snapshot + (*Field)->snapshotSize) free((*Field)->tiles[i]);
+			}
+			free((*Field)->tiles);
+		}
+		if (*Field && (*Field)->snapshot) munmap((*Field)->snapshot, (*Field)->snapshotSize);
+		if (*Field) freeSummary(*Field);
+		free(*Field);
+		*Field = NULL;
+		return EXIT_SUCCESS;
+	}
+
+	int buildField(field Field, settings Settings, uint64_t seed) {
+		point Opening = {Settings.fieldSize.x / 2, Settings.fieldSize.y / 2};
+
+		/* Some sanity checks */
+		if (Settings.mines > (long long) Settings.fieldSize.x * Settings.fieldSize.y) return EXIT_FAILURE; // No room for the mines! (Settings limits should prevent this)
+		if (Field->tileCount) return EXIT_FAILURE; // Tiles made before now wouldn't have any mines
+
+		Field->seed = seed;
+		Field->mines = Settings.mines;
+		if (HAS_OPTION(Settings, SAFE_START)) {
+			/* Wait for the first reveal to say where the mines mustn't be (see firstReveal()).
+			   The field can still be drawn until then, from the seed's mines, but a NO_GUESS layout can't be started. */
+			Field->pending = 1;
+			Field->generate = !HAS_OPTION(Settings, NO_GUESS);
+			return EXIT_SUCCESS;
+		}
+		if (HAS_OPTION(Settings, NO_GUESS)) {
+			/* Has to be laid out in full, and the opening revealed for the player */
+			if (FAILED(noGuessField(Field, Settings, seed, Opening))) return EXIT_FAILURE;
+			return (setPointTo(Field, Settings, Opening, DISPLAYED) < 0) ? EXIT_FAILURE : EXIT_SUCCESS;
+		}
+
+		/* Nothing is placed yet - each tile is generated from the seed when it is first used */
+		Field->generate = 1;
+		return EXIT_SUCCESS;
+	}
+
+	int firstReveal(field Field, settings Settings, point Point) {
+		uint64_t before[TILE_SIZE], after[TILE_SIZE], diff;
+		point Changed[18], Position, Square, Neighbour; // At most 9 mines leave the opening, and as many land elsewhere
+		minepoint* MinePoint;
+		tile* Tile;
+		int changed = 0, i, dx, dy;
+
+		Field->pending = 0;
+		if (HAS_OPTION(Settings, NO_GUESS)) {
+			return FAILED(noGuessField(Field, Settings, Field->seed, Point)) ? ENGINE_TOO_DENSE : 0;
+		}
+
+		/* Tiles that don't exist yet will be generated around Point. Those that do (from drawing the field)
+		   have the seed's mines already, so just the squares that differ are changed. Either way, the mines
+		   that moved may be next to a tile that exists, so all of them are counted as changed. */
+		for (Position.y = (Point.y > 0 ? Point.y - 1 : 0) >> TILE_SHIFT; Position.y <= (Point.y + 1) >> TILE_SHIFT; Position.y++)
+		for (Position.x = (Point.x > 0 ? Point.x - 1 : 0) >> TILE_SHIFT; Position.x <= (Point.x + 1) >> TILE_SHIFT; Position.x++) {
+			if ((Position.x << TILE_SHIFT) >= Settings.fieldSize.x || (Position.y << TILE_SHIFT) >= Settings.fieldSize.y) continue; // Off the field
+			Tile = getTile(Field, Position, 0);
+			Field->safe.x = Field->safe.y = -1;
+			seedMines(Field, Position, before);
+			Field->safe = Point;
+			seedMines(Field, Position, after);
+			for (Square.y=0; Square.y<TILE_SIZE; Square.y++) {
+				for (diff = before[Square.y] ^ after[Square.y]; diff; diff &= diff - 1) {
+					Square.x = __builtin_ctzll(diff);
+					Changed[changed].x = (Position.x << TILE_SHIFT) | Square.x;
+					Changed[changed++].y = (Position.y << TILE_SHIFT) | Square.y;
+					if (!Tile) continue;
+					MinePoint = &Tile->points[(Square.y << TILE_SHIFT) | Square.x];
+					if (getDisplay(*MinePoint) == FLAGGED) Field->State.correctFlags += isMine(*MinePoint) ? -1 : 1;
+					setValue(MinePoint, isMine(*MinePoint) ? 0 : -1); // Values are set below, once every mine has moved
+				}
+			}
+		}
+		Field->safe = Point;
+
+		/* Only squares next to a moved mine have a different value now */
+		for (i=0; i<changed; i++) for (dy=-1; dy<=1; dy++) for (dx=-1; dx<=1; dx++) {
+			Neighbour.x = Changed[i].x + dx;
+			Neighbour.y = Changed[i].y + dy;
+			if (Neighbour.x < 0 || Neighbour.x >= Settings.fieldSize.x || Neighbour.y < 0 || Neighbour.y >= Settings.fieldSize.y) continue;
+			Position.x = Neighbour.x >> TILE_SHIFT;
+			Position.y = Neighbour.y >> TILE_SHIFT;
+			if (!(Tile = getTile(Field, Position, 0))) continue; // Will be right when it is generated
+			MinePoint = &Tile->points[((Neighbour.y & TILE_MASK) << TILE_SHIFT) | (Neighbour.x & TILE_MASK)];
+			if (!isMine(*MinePoint)) setValue(MinePoint, minesAround(Field, Neighbour));
+		}
+		return 0;
+	}
+
+	uint64_t randomSeed(void) {
+		uint64_t seed = 0;
+		int fd = open("/dev/urandom", O_RDONLY);
+		if (fd < 0 || read(fd, &seed, sizeof(seed)) != sizeof(seed)) {
+			// Fall back to something that at least differs between processes
+			seed = mix64((uint64_t) time(NULL) ^ ((uint64_t) getpid() << 32) ^ (uint64_t) clock());
+		}
+		if (fd >= 0) close(fd);
+		return seed;
+	}
+
+	minepoint* getMinepoint(point Point, field Field, point FieldSize) {
+		tile* Tile = Field->lastTile;
+		point Position;
+		if (Point.x < 0 || Point.x >= FieldSize.x || Point.y < 0 || Point.y >= FieldSize.y)
+			return NULL; // Out of Bounds
+		Position.x = Point.x >> TILE_SHIFT;
+		Position.y = Point.y >> TILE_SHIFT;
+		if (!Tile || Tile->Position.x != Position.x || Tile->Position.y != Position.y) {
+			if (!(Tile = getTile(Field, Position, 1))) return NULL; // Out of memory
+			Field->lastTile = Tile;
+		}
+		return &Tile->points[((Point.y & TILE_MASK) << TILE_SHIFT) | (Point.x & TILE_MASK)];
+	}
+
+	int point2offset(point Point, int xsize) {
+		return Point.y * xsize + Point.x;
+	}
+
+	tile* getTile(field Field, point Position, int create) {
+		uint64_t key = ((uint64_t) (unsigned int) Position.y << 32) | (unsigned int) Position.x;
+		size_t mask = Field->tileSlots - 1;
+		size_t i;
+		tile* Tile;
+
+		for (i = mix64(key) & mask; (Tile = Field->tiles[i]); i = (i+1) & mask) {
+			if (Tile->Position.x == Position.x && Tile->Position.y == Position.y) return Tile;
+		}
+		if (!create) return NULL;
+
+		if (!(Tile = calloc(1, sizeof(tile)))) return NULL;
+		Tile->Position = Position;
+		generateTile(Field, Tile); // Even without mines of its own, it may border some
+		if (FAILED(addTile(Field, Tile))) {
+			free(Tile);
+			return NULL;
+		}
+
+		if (Field->ending != HIDDEN) {
+			/* The game is over, so this tile's mines should look like everyone else's */
+			point Size = getTileSize(Field, Position), Point;
+			for (Point.y=0; Point.y<Size.y; Point.y++) for (Point.x=0; Point.x<Size.x; Point.x++) {
+				minepoint* MinePoint = &Tile->points[(Point.y << TILE_SHIFT) | Point.x];
+				point Square = {(Position.x << TILE_SHIFT) | Point.x, (Position.y << TILE_SHIFT) | Point.y};
+				if (isMine(*MinePoint) && getDisplay(*MinePoint) == HIDDEN) setDisplay(Field, Square, MinePoint, Field->ending);
+			}
+		}
+		return Tile;
+	}
+
+	int addTile(field Field, tile* Tile) {
+		uint64_t key;
+		size_t mask, i, j;
+		tile* Other;
+
+		if ((Field->tileCount + 1) * 2 > Field->tileSlots) {
+			/* Keep the table at most half full, so probes stay short */
+			tile** tiles = calloc(Field->tileSlots * 2, sizeof(tile*));
+			if (!tiles) return EXIT_FAILURE;
+			mask = Field->tileSlots * 2 - 1;
+			for (j=0; j<Field->tileSlots; j++) {
+				if (!(Other = Field->tiles[j])) continue;
+				key = ((uint64_t) (unsigned int) Other->Position.y << 32) | (unsigned int) Other->Position.x;
+				for (i = mix64(key) & mask; tiles[i]; i = (i+1) & mask);
+				tiles[i] = Other;
+			}
+			free(Field->tiles);
+			Field->tiles = tiles;
+			Field->tileSlots *= 2;
+		}
+
+		mask = Field->tileSlots - 1;
+		key = ((uint64_t) (unsigned int) Tile->Position.y << 32) | (unsigned int) Tile->Position.x;
+		for (i = mix64(key) & mask; Field->tiles[i]; i = (i+1) & mask);
+		Field->tiles[i] = Tile;
+		Field->tileCount++;
+		return EXIT_SUCCESS;
+	}
+
+	point getTileSize(field Field, point Position) {
+		point Size;
+		Size.x = MIN(TILE_SIZE, Field->fieldSize.x - (Position.x << TILE_SHIFT));
+		Size.y = MIN(TILE_SIZE, Field->fieldSize.y - (Position.y << TILE_SHIFT));
+		return Size;
+	}
+
+	void generateTile(field Field, tile* Tile) {
+		unsigned char halo[TILE_SIZE+2][TILE_SIZE+2]; // 1 for each mine in this tile and the edges of its neighbours
+		uint64_t rows[TILE_SIZE];
+		point Neighbour;
+		int dx, dy, hx, hy;
+
+		memset(halo, 0, sizeof(halo));
+		for (dy=-1; dy<=1; dy++) for (dx=-1; dx<=1; dx++) {
+			Neighbour.x = Tile->Position.x + dx;
+			Neighbour.y = Tile->Position.y + dy;
+			if (Neighbour.x < 0 || Neighbour.y < 0 ||
+			    (Neighbour.x << TILE_SHIFT) >= Field->fieldSize.x || (Neighbour.y << TILE_SHIFT) >= Field->fieldSize.y)
+				continue; // Off the field
+			tileMines(Field, Neighbour, rows);
+			/* Copy in the part of the neighbour that overlaps the halo: all of it for ourselves, else one row or column */
+			for (hy = (dy < 0) ? 0 : (dy > 0) ? TILE_SIZE+1 : 1; hy <= ((dy < 0) ? 0 : (dy > 0) ? TILE_SIZE+1 : TILE_SIZE); hy++)
+			for (hx = (dx < 0) ? 0 : (dx > 0) ? TILE_SIZE+1 : 1; hx <= ((dx < 0) ? 0 : (dx > 0) ? TILE_SIZE+1 : TILE_SIZE); hx++) {
+				halo[hy][hx] = (rows[hy - 1 - dy*TILE_SIZE] >> (hx - 1 - dx*TILE_SIZE)) & 1;
+			}
+		}
+
+		neighbourCounts(&halo[0][0], TILE_SIZE+2, Tile->points, TILE_SIZE, TILE_SIZE, TILE_SIZE);
+	}
+
+	void recountField(field Field) {
+		size_t i;
+		for (i=0; i<Field->tileSlots; i++) {
+			if (Field->tiles[i]) generateTile(Field, Field->tiles[i]);
+		}
+	}
+
+	void neighbourCounts(const unsigned char* mines, int stride, minepoint* out, int outStride, int width, int height) {
+		/* Each value is a 3x3 box sum of mines: three rows added together, at three offsets.
+		   A mine's own square is in its sum, but ORing in MINEPOINT_MINE covers that up. */
+		const unsigned char *above, *row, *below;
+		minepoint* outRow;
+		int x, y, value;
+
+		for (y=0; y<height; y++) {
+			above = mines + y*stride;
+			row = above + stride;
+			below = row + stride;
+			outRow = out + y*outStride;
+			x = 0;
+			#ifdef __AVX2__
+				for (; x + 32 <= width; x += 32) {
+					__m256i sum = _mm256_setzero_si256(), centre, mask;
+					int dx;
+					for (dx=0; dx<3; dx++) {
+						sum = _mm256_add_epi8(sum, _mm256_loadu_si256((const __m256i*) (above + x + dx)));
+						sum = _mm256_add_epi8(sum, _mm256_loadu_si256((const __m256i*) (row + x + dx)));
+						sum = _mm256_add_epi8(sum, _mm256_loadu_si256((const __m256i*) (below + x + dx)));
+					}
+					centre = _mm256_loadu_si256((const __m256i*) (row + x + 1));
+					mask = _mm256_set1_epi8(MINEPOINT_VALUE);
+					sum = _mm256_or_si256(sum, _mm256_and_si256(_mm256_sub_epi8(_mm256_setzero_si256(), centre), mask)); // 0xFF for mines
+					_mm256_storeu_si256((__m256i*) (outRow + x), _mm256_or_si256(sum,
+						_mm256_andnot_si256(mask, _mm256_loadu_si256((const __m256i*) (outRow + x))))); // Keep the displays
+				}
+			#endif
+			#ifdef __SSE2__
+				for (; x + 16 <= width; x += 16) {
+					__m128i sum = _mm_setzero_si128(), centre, mask;
+					int dx;
+					for (dx=0; dx<3; dx++) {
+						sum = _mm_add_epi8(sum, _mm_loadu_si128((const __m128i*) (above + x + dx)));
+						sum = _mm_add_epi8(sum, _mm_loadu_si128((const __m128i*) (row + x + dx)));
+						sum = _mm_add_epi8(sum, _mm_loadu_si128((const __m128i*) (below + x + dx)));
+					}
+					centre = _mm_loadu_si128((const __m128i*) (row + x + 1));
+					mask = _mm_set1_epi8(MINEPOINT_VALUE);
+					sum = _mm_or_si128(sum, _mm_and_si128(_mm_sub_epi8(_mm_setzero_si128(), centre), mask)); // 0xFF for mines
+					_mm_storeu_si128((__m128i*) (outRow + x), _mm_or_si128(sum,
+						_mm_andnot_si128(mask, _mm_loadu_si128((const __m128i*) (outRow + x))))); // Keep the displays
+				}
+			#endif
+			for (; x < width; x++) {
+				value = above[x] + above[x+1] + above[x+2] + row[x] + row[x+1] + row[x+2] + below[x] + below[x+1] + below[x+2];
+				if (row[x+1]) value = MINEPOINT_MINE;
+				outRow[x] = (outRow[x] & ~MINEPOINT_VALUE) | value;
+			}
+		}
+	}
+
+	void tileMines(field Field, point Position, uint64_t* rows) {
+		point Size = getTileSize(Field, Position), Point;
+		tile* Tile = getTile(Field, Position, 0);
+
+		if (Tile) {
+			/* It already exists, and may have been changed since it was generated */
+			memset(rows, 0, TILE_SIZE * sizeof(uint64_t));
+			for (Point.y=0; Point.y<Size.y; Point.y++) for (Point.x=0; Point.x<Size.x; Point.x++) {
+				if (isMine(Tile->points[(Point.y << TILE_SHIFT) | Point.x])) rows[Point.y] |= (uint64_t) 1 << Point.x;
+			}
+			return;
+		}
+		if (!Field->generate) memset(rows, 0, TILE_SIZE * sizeof(uint64_t)); // Tiles start empty
+		else seedMines(Field, Position, rows);
+	}
+
+	void seedMines(field Field, point Position, uint64_t* rows) {
+		point Size = getTileSize(Field, Position), Low, High;
+		long long mines;
+		int i, j, cells, moved = 0;
+		uint64_t opening;
+		rng Rng;
+
+		/* Floyd's algorithm: a uniform choice of our mines from the tile's squares, using rows as the set of chosen squares */
+		memset(rows, 0, TILE_SIZE * sizeof(uint64_t));
+		mines = tileMineCount(Field, Position);
+		cells = Size.x * Size.y;
+		rngSeed(&Rng, mix64(Field->seed ^ mix64(((uint64_t) (unsigned int) Position.y << 32) | (unsigned int) Position.x)));
+		for (i = cells - mines; i < cells; i++) {
+			j = rngBelow(&Rng, i + 1);
+			if (rows[j / Size.x] & ((uint64_t) 1 << (j % Size.x))) j = i; // Already chosen, so take the new square instead
+			rows[j / Size.x] |= (uint64_t) 1 << (j % Size.x);
+		}
+		if (Field->safe.x < 0) return;
+
+		/* Move any mines in the 3x3 around safe to other squares of this tile, so the tile's count stays the same */
+		Low.x = Field->safe.x - 1 - (Position.x << TILE_SHIFT);
+		Low.y = Field->safe.y - 1 - (Position.y << TILE_SHIFT);
+		High.x = Low.x + 2;
+		High.y = Low.y + 2;
+		if (Low.x < 0) Low.x = 0;
+		if (Low.y < 0) Low.y = 0;
+		if (High.x >= Size.x) High.x = Size.x - 1;
+		if (High.y >= Size.y) High.y = Size.y - 1;
+		if (Low.x > High.x || Low.y > High.y) return; // Nowhere near this tile
+		opening = ((uint64_t) 2 << High.x) - ((uint64_t) 1 << Low.x); // Wraps to the right bits even for High.x = 63
+		for (i = Low.y; i <= High.y; i++) moved += __builtin_popcountll(rows[i] & opening);
+		if (moved > cells - mines - ((High.x - Low.x + 1) * (High.y - Low.y + 1) - moved)) return; // Nowhere to put them, so the opening can't be safe
+		for (i = Low.y; i <= High.y; i++) rows[i] &= ~opening;
+		while (moved) {
+			j = rngBelow(&Rng, cells);
+			if (rows[j / Size.x] & ((uint64_t) 1 << (j % Size.x))) continue; // Already a mine
+			if (j / Size.x >= Low.y && j / Size.x <= High.y && (opening & ((uint64_t) 1 << (j % Size.x)))) continue; // In the opening
+			rows[j / Size.x] |= (uint64_t) 1 << (j % Size.x);
+			moved--;
+		}
+	}
+
+	int minesAround(field Field, point Point) {
+		uint64_t rows[TILE_SIZE];
+		point Position, Cached = {-1, -1}, Neighbour;
+		tile* Tile;
+		int count = 0, dx, dy;
+
+		for (dy=-1; dy<=1; dy++) for (dx=-1; dx<=1; dx++) {
+			Neighbour.x = Point.x + dx;
+			Neighbour.y = Point.y + dy;
+			if ((!dx && !dy) || Neighbour.x < 0 || Neighbour.x >= Field->fieldSize.x || Neighbour.y < 0 || Neighbour.y >= Field->fieldSize.y) continue;
+			Position.x = Neighbour.x >> TILE_SHIFT;
+			Position.y = Neighbour.y >> TILE_SHIFT;
+			if ((Tile = getTile(Field, Position, 0))) {
+				count += isMine(Tile->points[((Neighbour.y & TILE_MASK) << TILE_SHIFT) | (Neighbour.x & TILE_MASK)]);
+				continue;
+			}
+			if (Cached.x != Position.x || Cached.y != Position.y) {
+				tileMines(Field, Position, rows); // Not made yet, so work out what it will have
+				Cached = Position;
+			}
+			count += (rows[Neighbour.y & TILE_MASK] >> (Neighbour.x & TILE_MASK)) & 1;
+		}
+		return count;
+	}
+
+	long long tileMineCount(field Field, point Position) {
+		/* The mines are split between halves of the (row-major) list of tiles, then halves of those, and so on,
+		   so any tile's share can be found without looking at any other tile, and they always add up exactly. */
+		long long tilesX = (Field->fieldSize.x + TILE_MASK) >> TILE_SHIFT;
+		long long tilesY = (Field->fieldSize.y + TILE_MASK) >> TILE_SHIFT;
+		long long index = Position.y * tilesX + Position.x;
+		long long lo = 0, hi = tilesX * tilesY, mid, left;
+		long long mines = Field->mines;
+
+		while (hi - lo > 1) {
+			mid = lo + (hi - lo) / 2;
+			left = splitMines(mix64(Field->seed ^ mix64(lo ^ mix64(hi))), mines,
+			                  tileCellsBefore(Field, hi) - tileCellsBefore(Field, lo),
+			                  tileCellsBefore(Field, mid) - tileCellsBefore(Field, lo));
+			if (index < mid) {
+				hi = mid;
+				mines = left;
+			} else {
+				lo = mid;
+				mines -= left;
+			}
+		}
+		return mines;
+	}
+
+	long long tileCellsBefore(field Field, long long index) {
+		long long tilesX = (Field->fieldSize.x + TILE_MASK) >> TILE_SHIFT;
+		long long row = index / tilesX, column = index % tilesX;
+		long long rowsAbove = row * TILE_SIZE, rowHeight, columnsLeft;
+		if (rowsAbove >= Field->fieldSize.y) return (long long) Field->fieldSize.x * Field->fieldSize.y;
+		rowHeight = MIN(TILE_SIZE, Field->fieldSize.y - rowsAbove);
+		columnsLeft = MIN(column * TILE_SIZE, Field->fieldSize.x);
+		return rowsAbove * Field->fieldSize.x + rowHeight * columnsLeft;
+	}
+
+	long long splitMines(uint64_t key, long long mines, long long cells, long long leftCells) {
+		const long long exactLimit = 1024; // Above this, ratio-of-uniforms sampling is used rather than one draw per mine or square
+		long long lo = MAX(0, mines - (cells - leftCells));
+		long long hi = MIN(mines, leftCells);
+		long long left = 0, remaining = mines, i;
+		long long few, many, sample, mode;
+		double mean, spread, width, bound, peak, u, v, x, t;
+		rng Rng;
+
+		if (lo == hi) return lo;
+		rngSeed(&Rng, key);
+		if (mines <= exactLimit) {
+			// Place each mine in turn, on the left with probability (free squares on the left / free squares)
+			for (i=0; i<mines; i++) {
+				if (rngBelow(&Rng, cells - i) < (uint64_t) (leftCells - left)) left++;
+			}
+			return left;
+		}
+		if (leftCells <= exactLimit) {
+			// Go through each square on the left, a mine with probability (mines left to place / squares left)
+			for (i=0; i<leftCells; i++) {
+				if (rngBelow(&Rng, cells - i) < (uint64_t) remaining) {
+					left++;
+					remaining--;
+				}
+			}
+			return left;
+		}
+		if (cells - mines <= exactLimit) return leftCells - splitMines(key, cells - mines, cells, leftCells); // Split the safe squares instead
+		if (cells - leftCells <= exactLimit) return mines - splitMines(key, mines, cells, cells - leftCells); // Split the other way
+
+		/* Stadlober's ratio-of-uniforms (HRUA) for the hypergeometric distribution: exact, and O(1) draws expected.
+		   Works with the smaller of mines and safe squares, and of the two sides, and maps back at the end. */
+		few = MIN(mines, cells - mines);
+		many = cells - few;
+		sample = MIN(leftCells, cells - leftCells);
+		mean = (double) sample * few / cells;
+		spread = sqrt((double) (cells - sample) * sample * ((double) few / cells) * ((double) many / cells) / (cells - 1) + 0.5);
+		width = 1.7155277699214135 * spread + 0.8989161620588988; // 2 * sqrt(2 / e) and 3 - 2 * sqrt(3 / e)
+		bound = MIN(MIN(sample, few) + 1, floor(mean + 0.5 + 16 * spread));
+		mode = (long long) floor((double) (sample + 1) * (few + 1) / (cells + 2));
+		peak = logFactorial(mode) + logFactorial(few - mode) + logFactorial(sample - mode) + logFactorial(many - sample + mode);
+		while (1) {
+			u = 1 - rngDouble(&Rng); // In (0, 1], so never divided by
+			v = rngDouble(&Rng);
+			x = mean + 0.5 + width * (v - 0.5) / u;
+			if (x < 0 || x >= bound) continue;
+			left = (long long) x;
+			t = peak - (logFactorial(left) + logFactorial(few - left) + logFactorial(sample - left) + logFactorial(many - sample + left));
+			if (u * (4 - u) - 3 <= t) break; // Quick accept
+			if (u * (u - t) >= 1) continue; // Quick reject
+			if (2 * log(u) <= t) break;
+		}
+		if (mines > cells - mines) left = sample - left; // Drew safe squares
+		if (sample < leftCells) left = mines - left; // Drew the right side
+		return left;
+	}
+
+	double logFactorial(long long n) {
+		int sign;
+		return lgamma_r(n + 1.0, &sign); // lgamma() would set the global signgam, so races between threads
+	}
+
+	uint64_t mix64(uint64_t x) {
+		x += 0x9E3779B97F4A7C15ULL;
+		x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+		return x ^ (x >> 31);
+	}
+
+	void rngSeed(rng* Rng, uint64_t key) {
+		// Fill the state from a splitmix64 sequence, which can't produce the all-zero state
+		int i;
+		for (i=0; i<4; i++) Rng->s[i] = mix64(key += 0x9E3779B97F4A7C15ULL);
+	}
+
+	uint64_t rngNext(rng* Rng) {
+		uint64_t* s = Rng->s;
+		uint64_t result = s[1] * 5;
+		uint64_t t = s[1] << 17;
+		result = ((result << 7) | (result >> 57)) * 9;
+		s[2] ^= s[0];
+		s[3] ^= s[1];
+		s[1] ^= s[2];
+		s[0] ^= s[3];
+		s[2] ^= t;
+		s[3] = (s[3] << 45) | (s[3] >> 19);
+		return result;
+	}
+
+	uint64_t rngBelow(rng* Rng, uint64_t n) {
+		// Lemire's method: multiply into [0, n), rejecting the few results that would make some values more likely
+		unsigned __int128 m = (unsigned __int128) rngNext(Rng) * n;
+		uint64_t low = (uint64_t) m;
+		if (low < n) {
+			uint64_t threshold = -n % n;
+			while (low < threshold) {
+				m = (unsigned __int128) rngNext(Rng) * n;
+				low = (uint64_t) m;
+			}
+		}
+		return (uint64_t) (m >> 64);
+	}
+
+	double rngDouble(rng* Rng) {
+		return (rngNext(Rng) >> 11) * (1.0 / 9007199254740992.0); // top 53 bits / 2^53
+	}
+
+	int isMine(minepoint MinePoint) {return (MinePoint & MINEPOINT_VALUE) == MINEPOINT_MINE;}
+
+	int getValue(minepoint MinePoint) {return isMine(MinePoint) ? -1 : (MinePoint & MINEPOINT_VALUE);}
+
+	void setValue(minepoint* MinePoint, int value) {
+		*MinePoint = (*MinePoint & ~MINEPOINT_VALUE) | (value == -1 ? MINEPOINT_MINE : value);
+	}
+
+	enum display getDisplay(minepoint MinePoint) {return (enum display) (MinePoint >> MINEPOINT_DISPLAY_SHIFT);}
+
+	void setDisplay(field Field, point Point, minepoint* MinePoint, enum display Display) {
+		gamestate* State = &Field->State;
+		enum display Old = getDisplay(*MinePoint);
+		if (Old == Display) return;
+		switch (Old) {
+			case HIDDEN: State->hidden--; break;
+			case FLAGGED: State->flagged--; State->correctFlags -= isMine(*MinePoint); break;
+			default: break;
+		}
+		switch (Display) {
+			case HIDDEN: State->hidden++; break;
+			case FLAGGED: State->flagged++; State->correctFlags += isMine(*MinePoint); break;
+			default: break;
+		}
+		*MinePoint = (*MinePoint & MINEPOINT_VALUE) | (Display << MINEPOINT_DISPLAY_SHIFT);
+		if (Field->Changes) recordChange(Field->Changes, (long long) Point.y * Field->fieldSize.x + Point.x, *MinePoint);
+		if (Field->Summary) summaryChange(Field, Point, (Display == DISPLAYED) - (Old == DISPLAYED), (Display == FLAGGED) - (Old == FLAGGED));
+	}
+
+	void watchField(field Field, changeset* Changes) {
+		Field->Changes = Changes;
+	}
+
+	void recordChange(changeset* Changes, long long offset, minepoint MinePoint) {
+		if (Changes->length == Changes->size) {
+			size_t size = Changes->size ? Changes->size * 2 : 256;
+			change* changes = realloc(Changes->changes, size * sizeof(change));
+			if (!changes) {
+				Changes->overflowed = 1;
+				return;
+			}
+			Changes->changes = changes;
+			Changes->size = size;
+		}
+		Changes->changes[Changes->length++] = ((change) offset << CHANGE_SHIFT) | MinePoint;
+	}
+
+	void clearChanges(changeset* Changes) {
+		Changes->length = 0;
+		Changes->overflowed = 0;
+	}
+
+	void freeChanges(changeset* Changes) {
+		free(Changes->changes);
+		Changes->changes = NULL;
+		Changes->length = Changes->size = 0;
+		Changes->overflowed = 0;
+	}
+
+	int setPointTo(field Field, settings Settings, point Point, enum display Display) {
+		return setPointToAs(Field, &Settings, Point, Display, Settings.options);
+	}
+
+	int setPointToInteractive(field Field, settings Settings, point Point, enum display Display) {
+		return setPointToAs(Field, &Settings, Point, Display, (DEFAULT_INTERACTIVE) & ENGINE_OPTIONS);
+	}
+
+	int setPointToNotTty(field Field, settings Settings, point Point, enum display Display) {
+		return setPointToAs(Field, &Settings, Point, Display, (DEFAULT_NOT_TTY) & ENGINE_OPTIONS);
+	}
+
+	SPECIALISED int setPointToAs(field Field, const settings* Settings, point Point, enum display Display, unsigned int options) {
+		minepoint* MinePoint;
+		int expanded;
+		STAT_COUNT(setPointTo, 1);
+		if (Point.x < 0 || Point.x >= Settings->fieldSize.x || Point.y < 0 || Point.y >= Settings->fieldSize.y) return ENGINE_OUT_OF_FIELD;
+		if (Display == DISPLAYED && Field->pending && (expanded = firstReveal(Field, *Settings, Point)) < 0) return expanded;
+		if (!(MinePoint = getMinepoint(Point, Field, Settings->fieldSize))) return ENGINE_NO_MEMORY;
+		switch (Display) {
+			case FLAGGED: // On flagged, toggle/error flag or ignore/error if displayed
+				switch (getDisplay(*MinePoint)) {
+					case HIDDEN:
+						if (options & STRICT_WIN_CHECKS) {
+							if (Field->State.flagged >= Settings->mines && (options & FRAGILE)) return ENGINE_UNCOVER;
+						}
+						setDisplay(Field, Point, MinePoint, FLAGGED);
+						break;
+					case FLAGGED:
+						if (options & FRAGILE) return ENGINE_UNCOVER;
+						setDisplay(Field, Point, MinePoint, HIDDEN);
+						break;
+					default:
+						break;
+				}
+				break;
+			case DISPLAYED: // On displayed, reveal and possibly expand zeroes.
+				if (getDisplay(*MinePoint) != DISPLAYED) {
+					if (getValue(*MinePoint) == 0 && (options & EXPAND_ZEROES)) {
+						if ((expanded = expandZeroes(Field, *Settings, Point)) < 0) return expanded;
+					} else {
+						setDisplay(Field, Point, MinePoint, DISPLAYED);
+					}
+				} else if (options & FRAGILE) return ENGINE_UNCOVER;
+				break;
+			default:
+				break;
+		}
+		return getValue(*MinePoint);
+	}
+
+	int expandZeroes(field Field, settings Settings, point Start) {
+		/* Scanline fill: Each span of hidden zeroes is revealed along with the cells bordering it,
+		   and any hidden zeroes in the rows above and below are pushed as seeds for further spans. */
+		point* stack;
+		int stackLength = 0, stackSize = 64;
+		int count = 0;
+		int left, right, x, dy, inRun;
+		point Seed, Point;
+		minepoint* MinePoint;
+
+		if (!(stack = malloc(stackSize * sizeof(point)))) return ENGINE_NO_MEMORY;
+		stack[stackLength++] = Start;
+
+		while (stackLength) {
+			Seed = stack[--stackLength];
+			if (!(MinePoint = getMinepoint(Seed, Field, Settings.fieldSize))) goto nomemory;
+			if (getDisplay(*MinePoint) == DISPLAYED) continue; // Filled as part of another span
+
+			/* Find the span of hidden zeroes containing Seed */
+			Point.y = Seed.y;
+			for (left = Seed.x; left > 0; left--) {
+				Point.x = left-1;
+				if (!(MinePoint = getMinepoint(Point, Field, Settings.fieldSize))) goto nomemory;
+				if (getValue(*MinePoint) != 0 || getDisplay(*MinePoint) == DISPLAYED) break;
+			}
+			for (right = Seed.x; right < Settings.fieldSize.x-1; right++) {
+				Point.x = right+1;
+				if (!(MinePoint = getMinepoint(Point, Field, Settings.fieldSize))) goto nomemory;
+				if (getValue(*MinePoint) != 0 || getDisplay(*MinePoint) == DISPLAYED) break;
+			}
+			left = MAX(left-1, 0); // Widen to include the bordering cells
+			right = MIN(right+1, Settings.fieldSize.x-1);
+
+			/* Reveal the span and the cells either side of it */
+			for (Point.x = left; Point.x <= right; Point.x++) {
+				if (!(MinePoint = getMinepoint(Point, Field, Settings.fieldSize))) goto nomemory;
+				if (getDisplay(*MinePoint) != DISPLAYED) {
+					setDisplay(Field, Point, MinePoint, DISPLAYED);
+					count++;
+				}
+			}
+
+			/* Reveal the rows above and below, seeding once per run of hidden zeroes */
+			for (dy = -1; dy <= 1; dy += 2) {
+				Point.y = Seed.y + dy;
+				if (Point.y < 0 || Point.y >= Settings.fieldSize.y) continue;
+				inRun = 0;
+				for (x = left; x <= right; x++) {
+					Point.x = x;
+					if (!(MinePoint = getMinepoint(Point, Field, Settings.fieldSize))) goto nomemory;
+					if (getDisplay(*MinePoint) != DISPLAYED && getValue(*MinePoint) == 0) {
+						if (!inRun) {
+							if (stackLength == stackSize) {
+								point* newStack = realloc(stack, (stackSize *= 2) * sizeof(point));
+								if (!newStack) goto nomemory;
+								stack = newStack;
+							}
+							stack[stackLength++] = Point;
+							STAT_MAX(expansionDepth, stackLength);
+						}
+						inRun = 1;
+						continue;
+					}
+					inRun = 0;
+					if (getDisplay(*MinePoint) == DISPLAYED) continue;
+					if (isMine(*MinePoint)) {
+						// Got a mine during expansion, this shouldn't happen!
+						free(stack);
+						return ENGINE_BAD_FIELD;
+					}
+					setDisplay(Field, Point, MinePoint, DISPLAYED);
+					count++;
+				}
+			}
+		}
+
+		free(stack);
+		STAT_COUNT(expansions, 1);
+		STAT_VALUE(ExpansionCells, count);
+		return count;
+
+	nomemory:
+		free(stack);
+		return ENGINE_NO_MEMORY;
+	}
+
+	int checkWin(field Field, settings Settings) {
+		return checkWinAs(Field, &Settings, Settings.options);
+	}
+
+	int checkWinInteractive(field Field, settings Settings) {
+		return checkWinAs(Field, &Settings, (DEFAULT_INTERACTIVE) & ENGINE_OPTIONS);
+	}
+
+	int checkWinNotTty(field Field, settings Settings) {
+		return checkWinAs(Field, &Settings, (DEFAULT_NOT_TTY) & ENGINE_OPTIONS);
+	}
+
+	SPECIALISED int checkWinAs(field Field, const settings* Settings, unsigned int options) {
+		int result;
+		STAT_START(start);
+		#ifdef _DEBUG
+			if (checkState(Field, *Settings) < 0) return ENGINE_BAD_STATE;
+		#endif
+		if (options & STRICT_WIN_CHECKS) {
+			result = (Field->State.hidden == 0);
+		} else {
+			// Win conditions: the count of HIDDEN or FLAGGED squares is equal to the number of mines
+			long long count = Field->State.hidden + Field->State.flagged;
+			if (count < Settings->mines) { // sanity check
+				result = ENGINE_OVER_REVEALED;
+			} else {
+				result = (count == Settings->mines);
+			}
+		}
+		STAT_TIME(CheckWinTime, start);
+		return result;
+	}
+
+	const enginevariant* chooseEngine(settings Settings) {
+		switch (Settings.options & ENGINE_OPTIONS) {
+			case (DEFAULT_INTERACTIVE) & ENGINE_OPTIONS: return &InteractiveEngine;
+			case (DEFAULT_NOT_TTY) & ENGINE_OPTIONS: return &NotTtyEngine;
+			default: return &GeneralEngine;
+		}
+	}
+
+	int checkState(field Field, settings Settings) {
+		size_t i;
+		point Size, Point;
+		minepoint MinePoint;
+		gamestate Count = {0, 0, 0};
+		Count.hidden = (long long) Settings.fieldSize.x * Settings.fieldSize.y; // Tiles that don't exist yet are all hidden
+		for (i=0; i<Field->tileSlots; i++) {
+			if (!Field->tiles[i]) continue;
+			Size = getTileSize(Field, Field->tiles[i]->Position);
+			Count.hidden -= Size.x * Size.y;
+			for (Point.y=0; Point.y<Size.y; Point.y++) for (Point.x=0; Point.x<Size.x; Point.x++) {
+				MinePoint = Field->tiles[i]->points[(Point.y << TILE_SHIFT) | Point.x];
+				if (getDisplay(MinePoint) == HIDDEN) Count.hidden++;
+				if (getDisplay(MinePoint) == FLAGGED) {
+					Count.flagged++;
+					Count.correctFlags += isMine(MinePoint);
+				}
+			}
+		}
+		if (Count.hidden != Field->State.hidden || Count.flagged != Field->State.flagged ||
+		    Count.correctFlags != Field->State.correctFlags) {
+			return ENGINE_BAD_STATE;
+		}
+		return 0;
+	}
+
+	void endField(field Field, enum display Display) {
+		size_t i;
+		point Size, Point, Square;
+		minepoint* MinePoint;
+		Field->ending = Display; // For tiles that don't exist yet
+		for (i=0; i<Field->tileSlots; i++) {
+			if (!Field->tiles[i]) continue;
+			Size = getTileSize(Field, Field->tiles[i]->Position);
+			for (Point.y=0; Point.y<Size.y; Point.y++) for (Point.x=0; Point.x<Size.x; Point.x++) {
+				MinePoint = &Field->tiles[i]->points[(Point.y << TILE_SHIFT) | Point.x];
+				Square.x = (Field->tiles[i]->Position.x << TILE_SHIFT) | Point.x;
+				Square.y = (Field->tiles[i]->Position.y << TILE_SHIFT) | Point.y;
+				if (isMine(*MinePoint) && (Display == FLAGGED || getDisplay(*MinePoint) == HIDDEN)) setDisplay(Field, Square, MinePoint, Display);
+			}
+		}
+	}
+
+	int saveField(field Field, settings Settings, const char* path) {
+		snapshotheader Header;
+		char* tmpPath;
+		size_t i;
+		int fd, good;
+
+		memset(&Header, 0, sizeof(Header));
+		memcpy(Header.magic, SNAPSHOT_MAGIC, sizeof(Header.magic));
+		Header.version = SNAPSHOT_VERSION;
+		Header.byteOrder = SNAPSHOT_BYTE_ORDER;
+		Header.tileBytes = sizeof(tile);
+		Header.ending = Field->ending;
+		Header.width = Settings.fieldSize.x;
+		Header.height = Settings.fieldSize.y;
+		Header.mines = Settings.mines;
+		Header.options = Settings.options;
+		Header.seed = Settings.seed;
+		Header.fieldSeed = Field->seed;
+		Header.generate = Field->generate;
+		Header.hidden = Field->State.hidden;
+		Header.flagged = Field->State.flagged;
+		Header.correctFlags = Field->State.correctFlags;
+		Header.tileCount = Field->tileCount;
+		Header.pending = Field->pending;
+		Header.hasSafe = (Field->safe.x >= 0);
+		Header.safeX = Field->safe.x;
+		Header.safeY = Field->safe.y;
+
+		/* Write to a temporary file beside the real one, then rename it over, so a crash never leaves half a snapshot */
+		if (!(tmpPath = malloc(strlen(path) + sizeof(".XXXXXX")))) return EXIT_FAILURE;
+		strcpy(tmpPath, path);
+		strcat(tmpPath, ".XXXXXX");
+		if ((fd = mkstemp(tmpPath)) < 0) {
+			free(tmpPath);
+			return EXIT_FAILURE;
+		}
+		good = !FAILED(writeAll(fd, &Header, sizeof(Header)));
+		for (i=0; good && i<Field->tileSlots; i++) {
+			if (Field->tiles[i]) good = !FAILED(writeAll(fd, Field->tiles[i], sizeof(tile)));
+		}
+		good = good && fsync(fd) == 0;
+		good = (close(fd) == 0) && good;
+		good = good && rename(tmpPath, path) == 0;
+		if (!good) unlink(tmpPath);
+		free(tmpPath);
+		return good ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	int loadField(field* Field, settings* Settings, const char* path) {
+		const snapshotheader* Header;
+		settings NewSettings;
+		field NewField = NULL;
+		struct stat Stat;
+		tile* Tiles;
+		point Tiled;
+		char* map;
+		uint64_t i;
+		int fd;
+
+		if ((fd = open(path, O_RDONLY)) < 0) return EXIT_FAILURE;
+		if (fstat(fd, &Stat) < 0 || Stat.st_size < (off_t) sizeof(snapshotheader)) {
+			close(fd);
+			return EXIT_FAILURE;
+		}
+		/* Private and writable: squares we change are copied, and the file is left alone */
+		map = mmap(NULL, Stat.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+		close(fd);
+		if (map == MAP_FAILED) return EXIT_FAILURE;
+
+		/* Check the header makes sense before trusting any of it */
+		Header = (const snapshotheader*) map;
+		if (memcmp(Header->magic, SNAPSHOT_MAGIC, sizeof(Header->magic)) || Header->version != SNAPSHOT_VERSION ||
+		    Header->byteOrder != SNAPSHOT_BYTE_ORDER || Header->tileBytes != sizeof(tile) || Header->ending > FLAGGED ||
+		    Header->width < 1 || Header->height < 1 || Header->mines < 0 || Header->mines > (int64_t) Header->width * Header->height ||
+		    Header->hidden < 0 || Header->flagged < 0 || Header->correctFlags < 0 || Header->correctFlags > Header->flagged ||
+		    Header->hidden + Header->flagged > (int64_t) Header->width * Header->height ||
+		    (Header->hasSafe && (Header->safeX < 0 || Header->safeX >= Header->width || Header->safeY < 0 || Header->safeY >= Header->height)) ||
+		    Header->tileCount != (Stat.st_size - sizeof(snapshotheader)) / sizeof(tile) ||
+		    (Stat.st_size - sizeof(snapshotheader)) % sizeof(tile)) {
+			munmap(map, Stat.st_size);
+			return EXIT_FAILURE;
+		}
+
+		NewSettings.fieldSize.x = Header->width;
+		NewSettings.fieldSize.y = Header->height;
+		NewSettings.mines = Header->mines;
+		NewSettings.options = Header->options;
+		NewSettings.seed = Header->seed;
+		if (FAILED(createField(&NewField, NewSettings))) {
+			munmap(map, Stat.st_size);
+			return EXIT_FAILURE;
+		}
+		NewField->snapshot = map; // From here on, freeing NewField unmaps it
+		NewField->snapshotSize = Stat.st_size;
+		NewField->seed = Header->fieldSeed;
+		NewField->generate = !!Header->generate;
+		NewField->pending = !!Header->pending;
+		if (Header->hasSafe) {
+			NewField->safe.x = Header->safeX;
+			NewField->safe.y = Header->safeY;
+		}
+		NewField->ending = (enum display) Header->ending;
+		NewField->State.hidden = Header->hidden;
+		NewField->State.flagged = Header->flagged;
+		NewField->State.correctFlags = Header->correctFlags;
+
+		/* The tiles are used where they lie in the mapping, so only their squares need checking */
+		Tiles = (tile*) (map + sizeof(snapshotheader));
+		Tiled.x = (Header->width + TILE_MASK) >> TILE_SHIFT;
+		Tiled.y = (Header->height + TILE_MASK) >> TILE_SHIFT;
+		for (i=0; i<Header->tileCount; i++) {
+			if (Tiles[i].Position.x < 0 || Tiles[i].Position.x >= Tiled.x || Tiles[i].Position.y < 0 || Tiles[i].Position.y >= Tiled.y ||
+			    getTile(NewField, Tiles[i].Position, 0) || !validTile(&Tiles[i]) || FAILED(addTile(NewField, &Tiles[i]))) {
+				freeField(&NewField);
+				return EXIT_FAILURE;
+			}
+		}
+
+		*Field = NewField;
+		*Settings = NewSettings;
+		return EXIT_SUCCESS;
+	}
+
+	int validTile(const tile* Tile) {
+		unsigned char bad = 0, value;
+		int i;
+		for (i=0; i<TILE_SIZE*TILE_SIZE; i++) {
+			/* Values 0-8 or a mine, and one of the three displays. Branch-free, so it vectorises. */
+			value = Tile->points[i] & MINEPOINT_VALUE;
+			bad |= (Tile->points[i] >> MINEPOINT_DISPLAY_SHIFT) > FLAGGED;
+			bad |= (unsigned char) (value - 9) < MINEPOINT_MINE - 9;
+		}
+		return !bad;
+	}
+
+	int writeAll(int fd, const void* data, size_t length) {
+		ssize_t r;
+		while (length) {
+			r = write(fd, data, length);
+			if (r < 0) {
+				if (errno == EINTR) continue;
+				return EXIT_FAILURE;
+			}
+			data = (const char*) data + r;
+			length -= r;
+		}
+		return EXIT_SUCCESS;
+	}
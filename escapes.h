@@ -8,6 +8,7 @@
 		#define CSI_CHARS(x) ((x)?'[':'\033') // Gets const char from CSI sequence: 0 for first char, 1 for second char.
 
 		#define CLEAR CSI "H" CSI "2J" // Clears screen. Returns cursor to (1,1).
+		#define BELL "\a" // Beeps (or flashes), to say something didn't work
 
 		/* Cursor */
 			#define SAVE_CURSOR CSI "s"
@@ -19,6 +20,8 @@
 			#define CURSOR_RIGHT CSI "C"
 			#define CURSOR_LEFT CSI "D"
 
+			#define SET_CURSOR_FMT CSI "%d;%dH" // printf format to move cursor to (row, column). 1-based.
+
 		/* Formatting */
 			#define BOLD CSI "1m"
 			#define UNFORMAT CSI "0m"
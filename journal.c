@@ -0,0 +1,201 @@
+	/*
+		Move journal: an append-only record of each game's settings and seed, and every move made in it,
+		so any game can be reproduced exactly.
+		The file is JOURNAL_MAGIC, then records. Each record starts with a varint tag whose low two bits
+		are an enum journalop. A JOURNAL_GAME record is followed by varints for the width, height, mines,
+		options and seed. Any other op is a move: the rest of the tag is its x, and a varint for y follows.
+		Varints are unsigned LEB128 (7 bits at a time, low first, top bit set on all but the last byte).
+	*/
+
+	/* Header File contains std headers, structs, other typedefs and function prototypes */
+		#include "minesweeper.h"
+
+	/* Standard Headers */
+		#include <stdlib.h>
+		#include <string.h>
+		#include <errno.h>
+
+		#include <unistd.h>
+		#include <fcntl.h>
+		#include <sys/stat.h>
+
+	/*Macros*/
+		#define FAILED(x) ((x) != EXIT_SUCCESS) // Macro for checking if a function call did not return EXIT_SUCCESS
+		#define VARINT_MAX 10 // Most bytes a 64 bit varint can take
+
+	/*Methods*/
+
+	int openJournal(journal* Journal, const char* path) {
+		struct stat Stat;
+		Journal->length = Journal->size = 0;
+		Journal->data = NULL;
+		if ((Journal->fd = open(path, O_WRONLY | O_CREAT | O_APPEND, 0644)) < 0) return EXIT_FAILURE;
+		if (fstat(Journal->fd, &Stat) < 0) {
+			closeJournal(Journal);
+			return EXIT_FAILURE;
+		}
+		if (Stat.st_size == 0 && FAILED(journalBytes(Journal, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC) - 1))) {
+			closeJournal(Journal);
+			return EXIT_FAILURE;
+		}
+		return EXIT_SUCCESS;
+	}
+
+	int journalGame(journal* Journal, settings Settings) {
+		if (Journal->fd < 0) return EXIT_SUCCESS; // Not journalling
+		if (FAILED(journalVarint(Journal, JOURNAL_GAME)) ||
+		    FAILED(journalVarint(Journal, Settings.fieldSize.x)) ||
+		    FAILED(journalVarint(Journal, Settings.fieldSize.y)) ||
+		    FAILED(journalVarint(Journal, Settings.mines)) ||
+		    FAILED(journalVarint(Journal, Settings.options)) ||
+		    FAILED(journalVarint(Journal, Settings.seed))) return EXIT_FAILURE;
+		return EXIT_SUCCESS;
+	}
+
+	int journalMove(journal* Journal, enum journalop Op, point Point) {
+		if (Journal->fd < 0) return EXIT_SUCCESS; // Not journalling
+		if (FAILED(journalVarint(Journal, ((uint64_t) Point.x << 2) | Op)) ||
+		    FAILED(journalVarint(Journal, Point.y))) return EXIT_FAILURE;
+		return EXIT_SUCCESS;
+	}
+
+	int journalVarint(journal* Journal, uint64_t value) {
+		unsigned char bytes[VARINT_MAX];
+		int length = 0;
+		while (value >= 0x80) {
+			bytes[length++] = (value & 0x7F) | 0x80;
+			value >>= 7;
+		}
+		bytes[length++] = value;
+		return journalBytes(Journal, bytes, length);
+	}
+
+	int journalBytes(journal* Journal, const void* data, size_t length) {
+		if (Journal->length + length > Journal->size) {
+			size_t size = Journal->size ? Journal->size : 4096;
+			char* newData;
+			while (size < Journal->length + length) size *= 2;
+			if (!(newData = realloc(Journal->data, size))) return EXIT_FAILURE;
+			Journal->data = newData;
+			Journal->size = size;
+		}
+		memcpy(Journal->data + Journal->length, data, length);
+		Journal->length += length;
+		return EXIT_SUCCESS;
+	}
+
+	int flushJournal(journal* Journal) {
+		size_t length = Journal->length;
+		Journal->length = 0;
+		if (Journal->fd < 0 || !length) return EXIT_SUCCESS;
+		return writeAll(Journal->fd, Journal->data, length);
+	}
+
+	int closeJournal(journal* Journal) {
+		int result = EXIT_SUCCESS;
+		if (Journal->fd >= 0) {
+			result = flushJournal(Journal);
+			if (close(Journal->fd) < 0) result = EXIT_FAILURE;
+		}
+		free(Journal->data);
+		Journal->data = NULL;
+		Journal->length = Journal->size = 0;
+		Journal->fd = -1;
+		return result;
+	}
+
+	int readVarint(const unsigned char** data, const unsigned char* end, uint64_t* value) {
+		int shift;
+		*value = 0;
+		for (shift = 0; *data < end && shift < 7*VARINT_MAX; shift += 7) {
+			*value |= (uint64_t) (**data & 0x7F) << shift;
+			if (!(*(*data)++ & 0x80)) return EXIT_SUCCESS;
+		}
+		return EXIT_FAILURE; // Ran off the end, or too long
+	}
+
+	int replayJournal(const char* path, int game, long long moves, field* Field, settings* Settings, replayinfo* Info) {
+		unsigned char* file = NULL;
+		const unsigned char *data, *end;
+		uint64_t tag, y, width, height, mines, options, seed;
+		size_t length = 0, size = 0;
+		ssize_t r;
+		int fd, value, result = EXIT_FAILURE, games = 0, recounted = 1;
+		point Point;
+
+		*Field = NULL;
+		Info->moves = Info->applied = 0;
+		Info->lost = 0;
+
+		/* Read it all in: even a long game is only a few bytes a move */
+		if ((fd = open(path, O_RDONLY)) < 0) return EXIT_FAILURE;
+		while (1) {
+			if (length == size) {
+				unsigned char* newFile = realloc(file, size = size ? size * 2 : 65536);
+				if (!newFile) goto done;
+				file = newFile;
+			}
+			r = read(fd, file + length, size - length);
+			if (r < 0 && errno == EINTR) continue;
+			if (r < 0) goto done;
+			if (r == 0) break;
+			length += r;
+		}
+		if (length < sizeof(JOURNAL_MAGIC) - 1 || memcmp(file, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC) - 1)) goto done;
+
+		data = file + sizeof(JOURNAL_MAGIC) - 1;
+		end = file + length;
+		while (data < end) {
+			if (FAILED(readVarint(&data, end, &tag))) break; // A crash can leave the last record unfinished
+			if ((tag & 3) == JOURNAL_GAME) {
+				if (games++ == game) break; // Past the end of the game we want
+				if (FAILED(readVarint(&data, end, &width)) || FAILED(readVarint(&data, end, &height)) ||
+				    FAILED(readVarint(&data, end, &mines)) || FAILED(readVarint(&data, end, &options)) ||
+				    FAILED(readVarint(&data, end, &seed))) break;
+				if (games != game) continue;
+				if (width < 1 || width > INT32_MAX || height < 1 || height > INT32_MAX || mines > width * height) goto done;
+
+				Settings->fieldSize.x = width;
+				Settings->fieldSize.y = height;
+				Settings->mines = mines;
+				Settings->options = options;
+				Settings->seed = seed;
+				if (FAILED(createField(Field, *Settings))) goto done;
+				if (HAS_OPTION(*Settings, GENERATE_MINES) && FAILED(buildField(*Field, *Settings, seed))) goto done;
+				continue;
+			}
+
+			if (FAILED(readVarint(&data, end, &y))) break;
+			if (games != game) continue; // Someone else's move
+			if (!*Field || (tag >> 2) >= (uint64_t) Settings->fieldSize.x || y >= (uint64_t) Settings->fieldSize.y) goto done;
+			Point.x = tag >> 2;
+			Point.y = y;
+
+			if ((tag & 3) == JOURNAL_MINE) {
+				/* Placed by hand, before any moves. Values are set once they are all in. */
+				minepoint* MinePoint = getMinepoint(Point, *Field, Settings->fieldSize);
+				if (!MinePoint || Info->moves) goto done;
+				setValue(MinePoint, -1);
+				recounted = 0;
+				continue;
+			}
+			if (!recounted) {
+				recountField(*Field);
+				recounted = 1;
+			}
+			Info->moves++;
+			if (Info->lost || (moves >= 0 && Info->applied >= moves)) continue; // Just counting the rest
+			value = setPointTo(*Field, *Settings, Point, ((tag & 3) == JOURNAL_FLAG) ? FLAGGED : DISPLAYED);
+			if (value == ENGINE_MINE && (tag & 3) == JOURNAL_REVEAL) Info->lost = 1;
+			else if (value < ENGINE_MINE) goto done; // Couldn't have happened in the game
+			Info->applied++;
+		}
+		if (*Field && !recounted) recountField(*Field); // Mines placed, but no moves
+		if (*Field) result = EXIT_SUCCESS;
+
+	done:
+		if (result != EXIT_SUCCESS && *Field) freeField(Field);
+		free(file);
+		close(fd);
+		return result;
+	}
@@ -0,0 +1,135 @@
+	/*
+		libminesweeper: A game handle over the engine, so other programs can host games
+		without the terminal front-end. See libminesweeper.h.
+	*/
+
+	/* Header File for the public interface */
+		#include "libminesweeper.h"
+
+	/* Header File contains std headers, structs, other typedefs and function prototypes */
+		#include "minesweeper.h"
+
+	/* Standard Headers */
+		#include <stdlib.h>
+
+	/* The public codes and options are the engine's own */
+		_Static_assert((int) MS_MINE == ENGINE_MINE && (int) MS_ERR_NOMEM == ENGINE_NO_MEMORY &&
+		               (int) MS_ERR_RANGE == ENGINE_OUT_OF_FIELD && (int) MS_ERR_UNCOVER == ENGINE_UNCOVER &&
+		               (int) MS_ERR_FIELD == ENGINE_BAD_FIELD && (int) MS_ERR_STATE == ENGINE_BAD_STATE &&
+		               (int) MS_ERR_DENSE == ENGINE_TOO_DENSE && (int) MS_ERR_REVEALED == ENGINE_OVER_REVEALED,
+		               "libminesweeper error codes must match enum engineerror");
+		_Static_assert(MS_EXPAND_ZEROES == EXPAND_ZEROES && MS_FRAGILE == FRAGILE && MS_STRICT_WIN_CHECKS == STRICT_WIN_CHECKS &&
+		               MS_NO_GUESS == NO_GUESS,
+		               "libminesweeper options must match the engine's");
+
+	/*Macros*/
+		#define FAILED(x) ((x) != EXIT_SUCCESS) // Macro for checking if a function call did not return EXIT_SUCCESS
+		#define MS_OPTIONS (MS_EXPAND_ZEROES | MS_FRAGILE | MS_STRICT_WIN_CHECKS | MS_NO_GUESS)
+		#define MAX_SIDE 1000000 // Same limit as the terminal front-end
+
+	/* Type Definitions */
+		struct msgame {
+			field Field;
+			settings Settings;
+			enum msstatus status;
+		};
+
+		static int endGame(msgame* Game); // Check for a win after a move, ending the game if so. Returns MS_OK or an error.
+
+	/*Methods*/
+
+	int msCreate(msgame** Game, int width, int height, long long mines, unsigned int options, uint64_t seed) {
+		*Game = NULL;
+		if (width < 1 || width > MAX_SIDE || height < 1 || height > MAX_SIDE || mines < 0 ||
+		    mines > (long long) width * height || (options & ~MS_OPTIONS)) return MS_ERR_ARGS;
+		if (!(*Game = calloc(1, sizeof(msgame)))) return MS_ERR_NOMEM;
+		(*Game)->Settings.fieldSize.x = width;
+		(*Game)->Settings.fieldSize.y = height;
+		(*Game)->Settings.mines = mines;
+		(*Game)->Settings.options = options | GENERATE_MINES | FIXED_SEED;
+		(*Game)->Settings.seed = seed;
+		(*Game)->status = MS_PLAYING;
+		if (FAILED(createField(&(*Game)->Field, (*Game)->Settings))) {
+			msDestroy(Game);
+			return MS_ERR_NOMEM;
+		}
+		if (FAILED(buildField((*Game)->Field, (*Game)->Settings, seed))) {
+			msDestroy(Game);
+			return (options & MS_NO_GUESS) ? MS_ERR_DENSE : MS_ERR_NOMEM; // Too dense to be solved, most likely
+		}
+		return MS_OK;
+	}
+
+	void msDestroy(msgame** Game) {
+		if (*Game) freeField(&(*Game)->Field);
+		free(*Game);
+		*Game = NULL;
+	}
+
+	int msReveal(msgame* Game, int x, int y) {
+		point Point = {x, y};
+		int value, result;
+		if (Game->status != MS_PLAYING) return MS_ERR_OVER;
+		if ((value = setPointTo(Game->Field, Game->Settings, Point, DISPLAYED)) == ENGINE_MINE) {
+			Game->status = MS_LOST;
+			endField(Game->Field, DISPLAYED);
+			return MS_MINE;
+		}
+		if (value < 0) return value;
+		if ((result = endGame(Game)) < 0) return result;
+		return value;
+	}
+
+	int msFlag(msgame* Game, int x, int y) {
+		point Point = {x, y};
+		int result;
+		if (Game->status != MS_PLAYING) return MS_ERR_OVER;
+		if ((result = setPointTo(Game->Field, Game->Settings, Point, FLAGGED)) < ENGINE_MINE) return result; // ENGINE_MINE is just what's under the flag
+		if ((result = endGame(Game)) < 0) return result;
+		return msQuery(Game, x, y) == MS_CELL_FLAGGED;
+	}
+
+	int msQuery(msgame* Game, int x, int y) {
+		point Point = {x, y};
+		minepoint* MinePoint;
+		if (x < 0 || x >= Game->Settings.fieldSize.x || y < 0 || y >= Game->Settings.fieldSize.y) return MS_ERR_RANGE;
+		if (!(MinePoint = getMinepoint(Point, Game->Field, Game->Settings.fieldSize))) return MS_ERR_NOMEM;
+		switch (getDisplay(*MinePoint)) {
+			case HIDDEN: return MS_CELL_HIDDEN;
+			case FLAGGED: return MS_CELL_FLAGGED;
+			default: return isMine(*MinePoint) ? MS_CELL_MINE : getValue(*MinePoint);
+		}
+	}
+
+	int msStatus(const msgame* Game) {
+		return Game->status;
+	}
+
+	int msCounts(const msgame* Game, long long* hidden, long long* flagged) {
+		*hidden = Game->Field->State.hidden;
+		*flagged = Game->Field->State.flagged;
+		return MS_OK;
+	}
+
+	uint64_t msSeed(const msgame* Game) {
+		return Game->Settings.seed;
+	}
+
+	const char* msStrerror(int error) {
+		switch (error) {
+			case MS_OK: return "Success";
+			case MS_ERR_ARGS: return "Invalid game settings";
+			case MS_ERR_OVER: return "The game is over";
+			default: return engineError(error);
+		}
+	}
+
+	static int endGame(msgame* Game) {
+		int won = checkWin(Game->Field, Game->Settings);
+		if (won < 0) return won;
+		if (won) {
+			Game->status = MS_WON;
+			endField(Game->Field, FLAGGED);
+		}
+		return MS_OK;
+	}
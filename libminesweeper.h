@@ -0,0 +1,68 @@
+
+	#ifndef LIBMINESWEEPER_H
+	#define LIBMINESWEEPER_H
+
+	/*
+		libminesweeper: the game engine on its own, with no terminal I/O.
+		Each game is an opaque handle, and games share nothing, so any number can be played
+		in one process (from different threads, as long as each game is used by one at a time).
+		Nothing here prints or exits: every error comes back as a negative return code.
+	*/
+
+	/* Standard Headers */
+		#include <stdint.h>
+
+	/* Type Definitions */
+
+		typedef struct msgame msgame; // A game in progress
+
+		enum msresult {
+			MS_OK = 0,
+			MS_MINE = -1, // Not an error as such: a mine was revealed, and the game is lost
+			MS_ERR_NOMEM = -2,
+			MS_ERR_RANGE = -3, // Point outside the field
+			MS_ERR_UNCOVER = -4, // MS_FRAGILE game given a pointless move (revealing a revealed square, unflagging, too many flags)
+			MS_ERR_FIELD = -5, // The field contradicts itself. Means a bug.
+			MS_ERR_STATE = -6, // The game's counters don't match the field. Means a bug.
+			MS_ERR_ARGS = -7, // Invalid size, mine count or options
+			MS_ERR_OVER = -8, // The game has already been won or lost
+			MS_ERR_DENSE = -9, // Too many mines for an MS_NO_GUESS field to be laid out
+			MS_ERR_REVEALED = -10 // More squares revealed than the field has safe ones. Means a bug.
+		};
+
+		enum msstatus {
+			MS_PLAYING = 0,
+			MS_WON,
+			MS_LOST
+		};
+
+		enum mscell {
+			/* 0 to 8 are revealed squares, by number of adjacent mines */
+			MS_CELL_HIDDEN = 9,
+			MS_CELL_FLAGGED,
+			MS_CELL_MINE // Only shown once the game is over
+		}; // What a player can see of a square
+
+		#define MS_EXPAND_ZEROES 1 // Revealing a 0 reveals all the squares around it
+		#define MS_FRAGILE 128 // Pointless moves are errors (MS_ERR_UNCOVER) rather than ignored
+		#define MS_STRICT_WIN_CHECKS 512 // All mines must be flagged to win, and no more flags than mines may be placed
+		#define MS_NO_GUESS 2048 /* The field can be solved without guessing, starting from the middle square, which
+		                            is revealed for you. Takes longer to create, and fails (MS_ERR_DENSE) if too dense. */
+
+	/*Primitives*/
+
+		int msCreate(msgame** Game, int width, int height, long long mines, unsigned int options, uint64_t seed); /*
+			Start a new game with mines randomly placed from seed. The same arguments always give the same field.
+			Puts the new game in Game. Returns MS_OK or an error. */
+		void msDestroy(msgame** Game); // Free a game, and set Game to NULL.
+		int msReveal(msgame* Game, int x, int y); /* Reveal a square. Returns its number of adjacent mines,
+		                                             MS_MINE if it was a mine, or an error. */
+		int msFlag(msgame* Game, int x, int y); // Toggle a flag. Returns 1 if the square is now flagged, 0 if not, or an error.
+		int msQuery(msgame* Game, int x, int y); // Returns what is shown at a square (0-8 or an enum mscell), or an error.
+		int msStatus(const msgame* Game); // Returns an enum msstatus.
+		int msCounts(const msgame* Game, long long* hidden, long long* flagged); /* Set the number of hidden and
+		                                                                            flagged squares. Returns MS_OK. */
+		uint64_t msSeed(const msgame* Game); // Returns the seed the game was created with.
+		const char* msStrerror(int error); // Returns a message for an enum msresult.
+
+	#endif
@@ -0,0 +1,347 @@
+	/*
+		Engine and display microbenchmarks.
+		Times the hot paths one at a time - field generation, zero expansion, moves and win checks,
+		and drawing frames to a pseudo-terminal - and prints the results as JSON, so runs on
+		different commits can be compared by a script.
+		Every field comes from a fixed master seed (or -s) and the run's index, so each commit
+		does exactly the same work. Each benchmark repeats until it has run for at least -t ms.
+	*/
+
+	#define _GNU_SOURCE // For posix_openpt() and friends
+
+	/* Header File contains std headers, structs, other typedefs and function prototypes */
+		#include "minesweeper.h"
+
+	/* Standard Headers */
+		#include <stdlib.h>
+		#include <stdio.h>
+		#include <errno.h>
+		#include <inttypes.h>
+		#include <time.h>
+		#include <fcntl.h>
+		#include <unistd.h>
+		#include <termios.h>
+		#include <pthread.h>
+		#include <signal.h>
+		#include <sys/ioctl.h>
+
+	/*Macros*/
+		#define FAILED(x) ((x) != EXIT_SUCCESS) // Macro for checking if a function call did not return EXIT_SUCCESS
+		#define CHECKS_PER_RUN 1000000 // checkWin() calls timed together, as one is too quick to time alone
+
+	/* Type Definitions */
+		typedef struct {
+			point fieldSize;
+			long long mines;
+		} benchfield;
+
+		typedef struct {
+			point fieldSize; // Field to draw
+			long long mines;
+			unsigned int options; // SIMPLE_OUTPUT for display()'s grid dump, else the scrolling interface
+			point screenSize;
+			int redraw; // Start each frame from a blank screen, rather than just moving the cursor
+		} benchdisplay;
+
+		typedef struct {
+			int fd; // Master side of the pseudo-terminal
+			long long bytes; // Everything read from it so far
+			pthread_t thread;
+		} drain;
+
+	/*Global Variables*/
+		const benchfield BuildFields[] = {
+			{{9, 9}, 10},
+			{{30, 16}, 99},
+			{{256, 256}, 6554},
+			{{256, 256}, 16384},
+			{{1024, 1024}, 157286}
+		};
+		const benchfield ExpandFields[] = {
+			{{256, 256}, 0},
+			{{1024, 1024}, 0}
+		};
+		const benchfield MoveFields[] = {
+			{{30, 16}, 99},
+			{{256, 256}, 6554}
+		};
+		const benchdisplay DisplayFields[] = {
+			{{30, 16}, 99, SIMPLE_OUTPUT | BORDER, {80, 24}, 0},
+			{{256, 256}, 6554, SIMPLE_OUTPUT | BORDER, {80, 24}, 0},
+			{{30, 16}, 99, BORDER | FORMATTING, {80, 24}, 1},
+			{{256, 256}, 6554, BORDER | FORMATTING, {200, 60}, 1},
+			{{256, 256}, 6554, BORDER | FORMATTING, {200, 60}, 0}
+		};
+
+		uint64_t masterSeed = 0x5EEDULL;
+		long long minimum = 200000000LL; // Nanoseconds each benchmark runs for, at least
+		int reported = 0; // Results printed so far
+
+	/* Prototypes */
+		void benchBuild(benchfield Bench); // createField(), buildField() and generating every tile.
+		void benchExpand(benchfield Bench); // Revealing a corner of a field with no mines, which reveals all of it.
+		void benchMoves(benchfield Bench); // Revealing every safe square in turn, with a checkWin() after each.
+		void benchCheckWin(benchfield Bench); // checkWin() alone, mid-game.
+		void benchDisplay(benchdisplay Bench); // Frames from display(), written to a pseudo-terminal.
+		void newField(field* Field, settings* Settings, benchfield Bench, unsigned int options, long long run); /*
+			Create and build the field for a run, generating every tile so later timings don't include it. */
+		void revealSome(field Field, settings Settings); // Reveal about half the safe squares, without expanding.
+		int openTerminal(point screenSize, drain* Drain); /* Open a raw pseudo-terminal of the given size,
+		                                                     put its slave on stdout and start draining the master.
+		                                                     Returns success. */
+		long long closeTerminal(drain* Drain, int savedStdout); /* Put savedStdout back, and wait for the drain to finish.
+		                                                           Returns the number of bytes written. */
+		void* drainTerminal(void* arg); // Thread body: read the pseudo-terminal until it closes.
+		void report(const char* name, settings Settings, long long runs, long long nanoseconds, long long cells, long long bytes); /*
+			Print one result. cells and bytes are totals over all runs; bytes is left out if negative. */
+		long long now(void); // Monotonic time, in nanoseconds.
+
+	/*Methods*/
+
+	int main(int argc, char *argv[]) {
+		int opt;
+		size_t i;
+		char* end;
+
+		err_file = stderr;
+		if (FAILED(watchScreenSize())) fatal("Could not catch SIGWINCH", EXIT_FAILURE);
+		while ((opt = getopt(argc, argv, "s:t:")) != -1) {
+			switch (opt) {
+				case 's': // Master seed
+					errno = 0;
+					masterSeed = strtoull(optarg, &end, 0);
+					if (errno || !*optarg || *end) {
+						fprintf(stderr, "Invalid seed: %s\n", optarg);
+						exit(EXIT_FAILURE);
+					}
+					break;
+				case 't': // Minimum time per benchmark, in ms
+					minimum = strtoll(optarg, &end, 0);
+					if (*end || !*optarg || minimum < 0) {
+						fprintf(stderr, "Invalid time: %s\n", optarg);
+						exit(EXIT_FAILURE);
+					}
+					minimum *= 1000000;
+					break;
+				default:
+					fprintf(stderr, "Usage: %s [-s seed] [-t ms]\n", argv[0]);
+					exit(EXIT_FAILURE);
+			}
+		}
+
+		printf("{\n\t\"seed\": \"0x%016" PRIx64 "\",\n\t\"results\": [", masterSeed);
+		for (i=0; i<sizeof(BuildFields)/sizeof(BuildFields[0]); i++) benchBuild(BuildFields[i]);
+		for (i=0; i<sizeof(ExpandFields)/sizeof(ExpandFields[0]); i++) benchExpand(ExpandFields[i]);
+		for (i=0; i<sizeof(MoveFields)/sizeof(MoveFields[0]); i++) benchMoves(MoveFields[i]);
+		for (i=0; i<sizeof(MoveFields)/sizeof(MoveFields[0]); i++) benchCheckWin(MoveFields[i]);
+		for (i=0; i<sizeof(DisplayFields)/sizeof(DisplayFields[0]); i++) benchDisplay(DisplayFields[i]);
+		printf("\n\t]\n}\n");
+		exit(EXIT_SUCCESS);
+	}
+
+	void benchBuild(benchfield Bench) {
+		long long run, start, total = 0;
+		settings Settings = {Bench.fieldSize, Bench.mines, GENERATE_MINES, 0};
+		field Field;
+		point Position;
+
+		for (run=0; total < minimum || !run; run++) {
+			Settings.seed = mix64(masterSeed ^ mix64((uint64_t) run));
+			start = now();
+			if (FAILED(createField(&Field, Settings)) || FAILED(buildField(Field, Settings, Settings.seed))) fatal("Could not build field", EXIT_FAILURE);
+			for (Position.y=0; Position.y<(Settings.fieldSize.y + TILE_MASK) >> TILE_SHIFT; Position.y++) {
+				for (Position.x=0; Position.x<(Settings.fieldSize.x + TILE_MASK) >> TILE_SHIFT; Position.x++) {
+					if (!getTile(Field, Position, 1)) fatal("Out of memory", EXIT_FAILURE);
+				}
+			}
+			total += now() - start;
+			freeField(&Field);
+		}
+		report("build", Settings, run, total, run * Settings.fieldSize.x * Settings.fieldSize.y, -1);
+	}
+
+	void benchExpand(benchfield Bench) {
+		long long run, start, total = 0, cells = 0;
+		settings Settings;
+		field Field;
+		point Corner = {0, 0};
+		int result;
+
+		for (run=0; total < minimum || !run; run++) {
+			newField(&Field, &Settings, Bench, EXPAND_ZEROES, run);
+			start = now();
+			result = setPointTo(Field, Settings, Corner, DISPLAYED);
+			total += now() - start;
+			if (result < 0) fatal(engineError(result), EXIT_FAILURE);
+			cells += (long long) Settings.fieldSize.x * Settings.fieldSize.y - Field->State.hidden;
+			freeField(&Field);
+		}
+		report("expand", Settings, run, total, cells, -1);
+	}
+
+	void benchMoves(benchfield Bench) {
+		long long run, start, total = 0, moves = 0;
+		settings Settings;
+		field Field;
+		point Point;
+		int result = 0;
+
+		for (run=0; total < minimum || !run; run++) {
+			newField(&Field, &Settings, Bench, 0, run);
+			start = now();
+			for (Point.y=0; Point.y<Settings.fieldSize.y; Point.y++) {
+				for (Point.x=0; Point.x<Settings.fieldSize.x; Point.x++) {
+					if (isMine(*getMinepoint(Point, Field, Settings.fieldSize))) continue;
+					if ((result = setPointTo(Field, Settings, Point, DISPLAYED)) < 0 ||
+					    (result = checkWin(Field, Settings)) < 0) fatal(engineError(result), EXIT_FAILURE);
+					moves++;
+				}
+			}
+			total += now() - start;
+			if (!result) fatal("Revealing every safe square did not win", EXIT_FAILURE);
+			freeField(&Field);
+		}
+		report("move", Settings, run, total, moves, -1);
+	}
+
+	void benchCheckWin(benchfield Bench) {
+		long long run, start, total = 0, i;
+		volatile int wins = 0; // Keeps the calls from being optimised out
+		settings Settings;
+		field Field;
+
+		for (run=0; total < minimum || !run; run++) {
+			newField(&Field, &Settings, Bench, 0, run);
+			revealSome(Field, Settings);
+			start = now();
+			for (i=0; i<CHECKS_PER_RUN; i++) wins += checkWin(Field, Settings);
+			total += now() - start;
+			freeField(&Field);
+		}
+		report("checkwin", Settings, run * CHECKS_PER_RUN, total, run * CHECKS_PER_RUN, -1);
+	}
+
+	void benchDisplay(benchdisplay Bench) {
+		benchfield Fields = {Bench.fieldSize, Bench.mines};
+		long long frames, start, total = 0;
+		settings Settings;
+		field Field;
+		point Cursor;
+		drain Drain;
+		int savedStdout;
+
+		newField(&Field, &Settings, Fields, Bench.options, 0);
+		revealSome(Field, Settings);
+		Cursor.x = Settings.fieldSize.x / 2;
+		Cursor.y = Settings.fieldSize.y / 2;
+
+		fflush(stdout); // Our results so far mustn't end up in the terminal
+		if ((savedStdout = dup(STDOUT_FILENO)) < 0 || FAILED(openTerminal(Bench.screenSize, &Drain))) fatal("Could not open a pseudo-terminal", EXIT_FAILURE);
+		raise(SIGWINCH); // As a terminal we were running in would, so the display picks up its size
+		resetDisplay();
+		Renderer = chooseRenderer(Settings); // As main() would
+		for (frames=0; total < minimum || !frames; frames++) {
+			if (Bench.redraw) resetDisplay();
+			else Cursor.x = Settings.fieldSize.x / 2 + (frames & 1); // Step back and forth, as arrow keys would
+			start = now();
+			if (FAILED(display(Field, Settings, Cursor))) fatal("Could not draw frame", EXIT_FAILURE);
+			total += now() - start;
+		}
+		resetDisplay();
+		Renderer = drawFrame;
+		report(HAS_OPTION(Settings, SIMPLE_OUTPUT) ? "display_simple" : Bench.redraw ? "display_redraw" : "display_cursor",
+		       Settings, frames, total, frames * Settings.fieldSize.x * Settings.fieldSize.y, closeTerminal(&Drain, savedStdout));
+		freeField(&Field);
+	}
+
+	void newField(field* Field, settings* Settings, benchfield Bench, unsigned int options, long long run) {
+		point Position;
+		Settings->fieldSize = Bench.fieldSize;
+		Settings->mines = Bench.mines;
+		Settings->options = options | GENERATE_MINES;
+		Settings->seed = mix64(masterSeed ^ mix64((uint64_t) run));
+		if (FAILED(createField(Field, *Settings)) || FAILED(buildField(*Field, *Settings, Settings->seed))) fatal("Could not build field", EXIT_FAILURE);
+		for (Position.y=0; Position.y<(Settings->fieldSize.y + TILE_MASK) >> TILE_SHIFT; Position.y++) {
+			for (Position.x=0; Position.x<(Settings->fieldSize.x + TILE_MASK) >> TILE_SHIFT; Position.x++) {
+				if (!getTile(*Field, Position, 1)) fatal("Out of memory", EXIT_FAILURE);
+			}
+		}
+	}
+
+	void revealSome(field Field, settings Settings) {
+		settings Reveal = Settings;
+		point Point;
+		Reveal.options &= ~EXPAND_ZEROES;
+		for (Point.y=0; Point.y<Settings.fieldSize.y; Point.y++) {
+			for (Point.x=0; Point.x<Settings.fieldSize.x; Point.x++) {
+				if (isMine(*getMinepoint(Point, Field, Settings.fieldSize))) continue;
+				if (!(mix64(Settings.seed ^ ((uint64_t) Point.y << 32 | (uint32_t) Point.x)) & 1)) continue;
+				if (setPointTo(Field, Reveal, Point, DISPLAYED) < 0) fatal("Could not reveal square", EXIT_FAILURE);
+			}
+		}
+	}
+
+	int openTerminal(point screenSize, drain* Drain) {
+		struct winsize Size = {0};
+		struct termios Termios;
+		int slave;
+
+		if ((Drain->fd = posix_openpt(O_RDWR | O_NOCTTY)) < 0) return EXIT_FAILURE;
+		if (grantpt(Drain->fd) < 0 || unlockpt(Drain->fd) < 0 || (slave = open(ptsname(Drain->fd), O_RDWR | O_NOCTTY)) < 0) {
+			close(Drain->fd);
+			return EXIT_FAILURE;
+		}
+		Size.ws_col = screenSize.x;
+		Size.ws_row = screenSize.y;
+		if (ioctl(slave, TIOCSWINSZ, &Size) < 0 || tcgetattr(slave, &Termios) < 0) goto failed;
+		cfmakeraw(&Termios); // So we count the bytes display() wrote, not what the terminal made of them
+		if (tcsetattr(slave, TCSANOW, &Termios) < 0 || dup2(slave, STDOUT_FILENO) < 0) goto failed;
+		close(slave);
+
+		Drain->bytes = 0;
+		if (pthread_create(&Drain->thread, NULL, drainTerminal, Drain)) fatal("Could not start drain thread", EXIT_FAILURE);
+		return EXIT_SUCCESS;
+
+	failed:
+		close(slave);
+		close(Drain->fd);
+		return EXIT_FAILURE;
+	}
+
+	long long closeTerminal(drain* Drain, int savedStdout) {
+		/* Once no slave is open, the master reads what is left and then fails, which ends the drain */
+		if (dup2(savedStdout, STDOUT_FILENO) < 0) fatal("Could not restore stdout", EXIT_FAILURE);
+		close(savedStdout);
+		pthread_join(Drain->thread, NULL);
+		close(Drain->fd);
+		return Drain->bytes;
+	}
+
+	void* drainTerminal(void* arg) {
+		drain* Drain = arg;
+		char buffer[65536];
+		ssize_t r;
+		while ((r = read(Drain->fd, buffer, sizeof(buffer))) != 0) {
+			if (r < 0) {
+				if (errno == EINTR) continue;
+				break;
+			}
+			Drain->bytes += r;
+		}
+		return NULL;
+	}
+
+	void report(const char* name, settings Settings, long long runs, long long nanoseconds, long long cells, long long bytes) {
+		printf("%s\n\t\t{\"name\": \"%s\", \"width\": %d, \"height\": %d, \"mines\": %lld, \"runs\": %lld, "
+		       "\"ns_per_op\": %.1f, \"ns_per_cell\": %.3f", reported++ ? "," : "", name,
+		       Settings.fieldSize.x, Settings.fieldSize.y, Settings.mines, runs,
+		       (double) nanoseconds / runs, cells ? (double) nanoseconds / cells : 0.0);
+		if (bytes >= 0) printf(", \"bytes_per_op\": %.1f", (double) bytes / runs);
+		printf("}");
+	}
+
+	long long now(void) {
+		struct timespec Time;
+		clock_gettime(CLOCK_MONOTONIC, &Time);
+		return (long long) Time.tv_sec * 1000000000LL + Time.tv_nsec;
+	}
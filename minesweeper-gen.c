@@ -0,0 +1,340 @@
+	/*
+		Bulk field generator.
+		Writes the mines of many generated fields of one size, across all cores, for datasets.
+		Field i is built from the master seed and i alone, just as minesweeper-sim's game i is,
+		and its mines are exactly those the game would place (see buildField() and tileMines()).
+		Workers fill chunks of consecutive fields, and the main thread writes the chunks out in order,
+		so the output doesn't depend on the number of threads.
+		The output is a genheader, then a record per field: its seed (a uint64_t), then its mines as a
+		bitmap, row by row, where square (x, y) is bit (y * width + x) % 8 of byte (y * width + x) / 8.
+		Numbers are in the machine's byte order, which byteOrder tells.
+	*/
+
+	/* Header File contains std headers, structs, other typedefs and function prototypes */
+		#include "minesweeper.h"
+
+	/* Standard Headers */
+		#include <stdlib.h>
+		#include <stdio.h>
+		#include <string.h>
+		#include <errno.h>
+		#include <math.h>
+		#include <time.h>
+		#include <unistd.h>
+		#include <fcntl.h>
+		#include <pthread.h>
+
+	/*Macros*/
+		#define FAILED(x) ((x) != EXIT_SUCCESS) // Macro for checking if a function call did not return EXIT_SUCCESS
+		#define MAX_THREADS 1024
+		#define GEN_MAGIC "MSWPGEN1"
+		#define GEN_BYTE_ORDER 0x01020304 // Reads back differently on a machine of the other endianness
+		#define GEN_CHUNK (1 << 20) // Bytes of fields a worker fills at a time (at least one field)
+		#define GEN_MEMORY (256 << 20) // Most bytes of chunks to hold at once (at least two chunks)
+		#define MIN(x,y) ((x)<(y))?(x):(y) // Warning: Do not use with things with side-effects!
+
+	/* Type Definitions */
+		typedef struct {
+			char magic[8]; // GEN_MAGIC, not nul-terminated
+			uint32_t byteOrder; // GEN_BYTE_ORDER
+			int32_t width;
+			int32_t height;
+			uint32_t recordSize; // Bytes per field: 8 for the seed, and the bitmap
+			int64_t mines;
+			uint64_t fields;
+			uint64_t masterSeed;
+		} genheader; // Start of the output. Each field's seed is mix64(masterSeed ^ mix64(its index)).
+		_Static_assert(sizeof(genheader) == 48, "genheader changed size");
+
+		typedef struct {
+			unsigned char* data;
+			long long fields; // How many fields data holds
+			int ready; // Set once data is filled, until it is written
+		} genchunk;
+
+		typedef struct {
+			settings Settings;
+			uint64_t masterSeed;
+			long long fields;
+			long long perChunk; // Fields in every chunk but the last
+			long long chunks;
+			size_t recordSize;
+			int slots; // Chunk n is filled in Chunks[n % slots]
+			genchunk* Chunks;
+			pthread_mutex_t lock; // Guards everything below, and the Chunks' ready flags
+			pthread_cond_t filled; // Signalled when a chunk is ready
+			pthread_cond_t written; // Signalled when a chunk has been written
+			long long next; // Next chunk to fill
+			long long done; // Chunks written so far
+			int failed; // Set if a worker or the writer failed, to stop everyone
+		} generator;
+
+		void* runWorker(void* arg); // Thread body: fill chunks until there are none left.
+		int packField(field Field, settings Settings, unsigned char* bitmap, uint64_t* rows); /* Write Field's mines to
+			bitmap, using rows (TILE_SIZE for each tile across) to hold a row of tiles at a time. Returns success. */
+		void putBits(unsigned char** out, uint64_t* pending, int* count, uint64_t bits, int length); /*
+			Add length low bits to those pending, writing them out 64 at a time. */
+		int writeChunks(generator* Gen, int fd); // Write every chunk out, in order, as they are filled. Returns success.
+		void stopGenerator(generator* Gen); // Mark Gen failed and wake everyone waiting on it.
+		long long elapsed(const struct timespec* start, const struct timespec* stop); // Nanoseconds between start and stop.
+
+	/*Methods*/
+
+	int main(int argc, char *argv[]) {
+		int opt, i, threads = 0, fd = STDOUT_FILENO;
+		long long value;
+		double density = -1, seconds;
+		char* end;
+		const char* path = NULL;
+		struct timespec start, stop;
+		pthread_t* Threads;
+		genheader Header;
+		generator Gen;
+
+		memset(&Gen, 0, sizeof(Gen));
+		Gen.Settings.fieldSize.x = 30; // Expert, unless told otherwise
+		Gen.Settings.fieldSize.y = 16;
+		Gen.Settings.mines = 99;
+		Gen.Settings.options = GENERATE_MINES;
+		Gen.masterSeed = 0x5EEDULL;
+		Gen.fields = 100000;
+
+		err_file = stderr;
+		while ((opt = getopt(argc, argv, "n:j:x:y:m:d:s:o:")) != -1) {
+			switch (opt) {
+				case 's': // Master seed
+					errno = 0;
+					Gen.masterSeed = strtoull(optarg, &end, 0);
+					if (errno || !*optarg || *end) {
+						fprintf(stderr, "Invalid seed: %s\n", optarg);
+						exit(EXIT_FAILURE);
+					}
+					break;
+				case 'o': // Write here instead of stdout
+					path = optarg;
+					break;
+				case 'd': // Mines as a fraction of the squares, instead of -m
+					density = strtod(optarg, &end);
+					if (*end || !*optarg || !(density >= 0 && density <= 1)) {
+						fprintf(stderr, "Invalid density: %s\n", optarg);
+						exit(EXIT_FAILURE);
+					}
+					break;
+				case 'n':
+				case 'j':
+				case 'x':
+				case 'y':
+				case 'm':
+					value = strtoll(optarg, &end, 0);
+					if (*end || !*optarg || value < (opt == 'm' ? 0 : 1) || (opt != 'n' && opt != 'm' && value > (opt == 'j' ? MAX_THREADS : 30000))) {
+						fprintf(stderr, "Invalid value for -%c: %s\n", opt, optarg);
+						exit(EXIT_FAILURE);
+					}
+					if (opt == 'n') Gen.fields = value;
+					else if (opt == 'j') threads = (int) value;
+					else if (opt == 'x') Gen.Settings.fieldSize.x = (int) value;
+					else if (opt == 'y') Gen.Settings.fieldSize.y = (int) value;
+					else Gen.Settings.mines = value;
+					break;
+				default:
+					fprintf(stderr, "Usage: %s [-n fields] [-j threads] [-x width] [-y height] [-m mines | -d density] [-s seed] [-o file]\n", argv[0]);
+					exit(EXIT_FAILURE);
+			}
+		}
+		if (density >= 0) Gen.Settings.mines = llround(density * Gen.Settings.fieldSize.x * Gen.Settings.fieldSize.y);
+		if (Gen.Settings.mines > (long long) Gen.Settings.fieldSize.x * Gen.Settings.fieldSize.y) {
+			fprintf(stderr, "Too many mines for a %dx%d field\n", Gen.Settings.fieldSize.x, Gen.Settings.fieldSize.y);
+			exit(EXIT_FAILURE);
+		}
+		if (path) {
+			if ((fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644)) < 0) {
+				perror("Could not open output");
+				exit(EXIT_FAILURE);
+			}
+		} else if (isatty(STDOUT_FILENO)) {
+			fprintf(stderr, "Not writing fields to a terminal. Redirect stdout, or use -o file.\n");
+			exit(EXIT_FAILURE);
+		}
+		if (!threads) {
+			value = sysconf(_SC_NPROCESSORS_ONLN);
+			threads = (value < 1) ? 1 : (value > MAX_THREADS) ? MAX_THREADS : (int) value;
+		}
+
+		/* Chunks of about GEN_CHUNK bytes, two for each worker so none waits on the writer, unless that's too much memory */
+		Gen.recordSize = sizeof(uint64_t) + ((long long) Gen.Settings.fieldSize.x * Gen.Settings.fieldSize.y + 7) / 8;
+		Gen.perChunk = (Gen.recordSize >= GEN_CHUNK) ? 1 : GEN_CHUNK / Gen.recordSize;
+		Gen.chunks = (Gen.fields + Gen.perChunk - 1) / Gen.perChunk;
+		if (threads > Gen.chunks) threads = (Gen.chunks < 1) ? 1 : (int) Gen.chunks;
+		Gen.slots = (int) MIN((long long) threads * 2, (long long) (GEN_MEMORY / (Gen.perChunk * Gen.recordSize)));
+		if (Gen.slots < 2) Gen.slots = 2;
+		if (!(Gen.Chunks = calloc(Gen.slots, sizeof(genchunk))) || !(Threads = malloc(threads * sizeof(pthread_t)))) fatal("Out of memory", EXIT_FAILURE);
+		for (i=0; i<Gen.slots; i++) {
+			if (!(Gen.Chunks[i].data = malloc(Gen.perChunk * Gen.recordSize))) fatal("Out of memory", EXIT_FAILURE);
+		}
+		pthread_mutex_init(&Gen.lock, NULL);
+		pthread_cond_init(&Gen.filled, NULL);
+		pthread_cond_init(&Gen.written, NULL);
+
+		memset(&Header, 0, sizeof(Header));
+		memcpy(Header.magic, GEN_MAGIC, sizeof(Header.magic));
+		Header.byteOrder = GEN_BYTE_ORDER;
+		Header.width = Gen.Settings.fieldSize.x;
+		Header.height = Gen.Settings.fieldSize.y;
+		Header.recordSize = Gen.recordSize;
+		Header.mines = Gen.Settings.mines;
+		Header.fields = Gen.fields;
+		Header.masterSeed = Gen.masterSeed;
+		if (FAILED(writeAll(fd, &Header, sizeof(Header)))) {
+			perror("Could not write output");
+			exit(EXIT_FAILURE);
+		}
+
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		for (i=0; i<threads; i++) {
+			if (pthread_create(&Threads[i], NULL, runWorker, &Gen)) fatal("Could not start worker thread", EXIT_FAILURE);
+		}
+		if (FAILED(writeChunks(&Gen, fd))) perror("Could not write output");
+		for (i=0; i<threads; i++) pthread_join(Threads[i], NULL);
+		clock_gettime(CLOCK_MONOTONIC, &stop);
+		seconds = elapsed(&start, &stop) / 1e9;
+		if (Gen.failed) fatal("Could not generate every field", EXIT_FAILURE);
+		if (path && close(fd) < 0) {
+			perror("Could not write output");
+			exit(EXIT_FAILURE);
+		}
+
+		for (i=0; i<Gen.slots; i++) free(Gen.Chunks[i].data);
+		free(Gen.Chunks);
+		free(Threads);
+		pthread_mutex_destroy(&Gen.lock);
+		pthread_cond_destroy(&Gen.filled);
+		pthread_cond_destroy(&Gen.written);
+
+		/* Stdout may well be the fields, so this goes to stderr */
+		fprintf(stderr, "field        %dx%d, %lld mines\n", Gen.Settings.fieldSize.x, Gen.Settings.fieldSize.y, Gen.Settings.mines);
+		fprintf(stderr, "threads      %d\n", threads);
+		fprintf(stderr, "fields       %lld (%zu bytes each)\n", Gen.fields, Gen.recordSize);
+		fprintf(stderr, "throughput   %.1f fields/s, %.1f MB/s (%.3f s)\n", Gen.fields / seconds,
+		        Gen.fields * Gen.recordSize / seconds / 1e6, seconds);
+		exit(EXIT_SUCCESS);
+	}
+
+	void* runWorker(void* arg) {
+		generator* Gen = arg;
+		settings Settings = Gen->Settings;
+		int tilesAcross = ((Settings.fieldSize.x - 1) >> TILE_SHIFT) + 1;
+		uint64_t* rows = malloc(tilesAcross * TILE_SIZE * sizeof(uint64_t));
+		field Field = NULL;
+		genchunk* Chunk;
+		long long chunk, i, first;
+		unsigned char* record;
+
+		err_file = stderr;
+		/* One field does for every seed, as looking at its mines never makes any tiles */
+		if (!rows || FAILED(createField(&Field, Settings))) {
+			stopGenerator(Gen);
+			goto done;
+		}
+
+		while (1) {
+			/* Claim the next chunk, and wait for the writer to be done with the last one in its slot */
+			pthread_mutex_lock(&Gen->lock);
+			chunk = Gen->next++;
+			while (!Gen->failed && chunk < Gen->chunks && chunk >= Gen->done + Gen->slots) pthread_cond_wait(&Gen->written, &Gen->lock);
+			if (Gen->failed || chunk >= Gen->chunks) chunk = -1;
+			pthread_mutex_unlock(&Gen->lock);
+			if (chunk < 0) break;
+
+			Chunk = &Gen->Chunks[chunk % Gen->slots];
+			first = chunk * Gen->perChunk;
+			Chunk->fields = MIN(Gen->perChunk, Gen->fields - first);
+			for (i=0, record = Chunk->data; i<Chunk->fields; i++, record += Gen->recordSize) {
+				Settings.seed = mix64(Gen->masterSeed ^ mix64((uint64_t) (first + i)));
+				memcpy(record, &Settings.seed, sizeof(uint64_t));
+				if (FAILED(buildField(Field, Settings, Settings.seed)) || FAILED(packField(Field, Settings, record + sizeof(uint64_t), rows))) {
+					stopGenerator(Gen);
+					goto done;
+				}
+			}
+
+			pthread_mutex_lock(&Gen->lock);
+			Chunk->ready = 1;
+			pthread_cond_broadcast(&Gen->filled);
+			pthread_mutex_unlock(&Gen->lock);
+		}
+
+	done:
+		if (Field) freeField(&Field);
+		free(rows);
+		return NULL;
+	}
+
+	int packField(field Field, settings Settings, unsigned char* bitmap, uint64_t* rows) {
+		int tilesAcross = ((Settings.fieldSize.x - 1) >> TILE_SHIFT) + 1, lastWidth = Settings.fieldSize.x - ((tilesAcross - 1) << TILE_SHIFT);
+		uint64_t pending = 0;
+		int count = 0, y;
+		point Position;
+
+		if (Field->tileCount) return EXIT_FAILURE; // A tile's mines could have been changed since it was generated
+		for (Position.y = 0; Position.y << TILE_SHIFT < Settings.fieldSize.y; Position.y++) {
+			for (Position.x = 0; Position.x < tilesAcross; Position.x++) tileMines(Field, Position, rows + (Position.x << TILE_SHIFT));
+			for (y = 0; y < TILE_SIZE && (Position.y << TILE_SHIFT) + y < Settings.fieldSize.y; y++) {
+				for (Position.x = 0; Position.x < tilesAcross - 1; Position.x++) putBits(&bitmap, &pending, &count, rows[(Position.x << TILE_SHIFT) + y], TILE_SIZE);
+				putBits(&bitmap, &pending, &count, rows[(Position.x << TILE_SHIFT) + y], lastWidth);
+			}
+		}
+		for (; count > 0; count -= 8, pending >>= 8) *bitmap++ = (unsigned char) pending; // The last few bits, in whole bytes
+		return EXIT_SUCCESS;
+	}
+
+	void putBits(unsigned char** out, uint64_t* pending, int* count, uint64_t bits, int length) {
+		int i;
+		*pending |= bits << *count; // Bits past length are clear, so nothing else is disturbed
+		if (*count + length < 64) {
+			*count += length;
+			return;
+		}
+		for (i=0; i<8; i++) (*out)[i] = (unsigned char) (*pending >> (8 * i)); // Low byte first, whatever the machine's order
+		*out += 8;
+		*pending = *count ? bits >> (64 - *count) : 0;
+		*count += length - 64;
+	}
+
+	int writeChunks(generator* Gen, int fd) {
+		genchunk* Chunk;
+		long long chunk;
+		int ready;
+
+		for (chunk = 0; chunk < Gen->chunks; chunk++) {
+			Chunk = &Gen->Chunks[chunk % Gen->slots];
+			pthread_mutex_lock(&Gen->lock);
+			while (!Gen->failed && !Chunk->ready) pthread_cond_wait(&Gen->filled, &Gen->lock);
+			ready = !Gen->failed;
+			pthread_mutex_unlock(&Gen->lock);
+			if (!ready) return EXIT_SUCCESS; // A worker failed, and has said so
+
+			if (FAILED(writeAll(fd, Chunk->data, Chunk->fields * Gen->recordSize))) {
+				stopGenerator(Gen);
+				return EXIT_FAILURE;
+			}
+
+			pthread_mutex_lock(&Gen->lock);
+			Chunk->ready = 0;
+			Gen->done = chunk + 1;
+			pthread_cond_broadcast(&Gen->written);
+			pthread_mutex_unlock(&Gen->lock);
+		}
+		return EXIT_SUCCESS;
+	}
+
+	void stopGenerator(generator* Gen) {
+		pthread_mutex_lock(&Gen->lock);
+		Gen->failed = 1;
+		pthread_cond_broadcast(&Gen->filled);
+		pthread_cond_broadcast(&Gen->written);
+		pthread_mutex_unlock(&Gen->lock);
+	}
+
+	long long elapsed(const struct timespec* start, const struct timespec* stop) {
+		return (stop->tv_sec - start->tv_sec) * 1000000000LL + (stop->tv_nsec - start->tv_nsec);
+	}
@@ -0,0 +1,677 @@
+	/*
+		Game server: many independent games in one process, played over a Unix-domain or localhost TCP socket.
+		Each connection is a session with a field of its own, or shares one with everyone who joined it by name.
+		Everything runs in one thread, around one epoll loop: sockets are non-blocking, each session's input
+		is split into lines as it arrives, and its replies are gathered in a buffer of its own, which is
+		written out once every event in a wakeup has been handled (or when the socket can take more).
+		An idle session is just its buffers and a field with no tiles yet, so tens of thousands cost little.
+
+		The protocol is the SIMPLE_INPUT one, a line at a time:
+			u x y      Reveal a square
+			f x y      Toggle a flag
+			g          Get the field: a line per row, of one character per square, as SIMPLE_OUTPUT draws them
+			n [w h m]  Start a game of your own (of the server's size, unless one is given)
+			j name     Join everyone else playing the game called name, starting it if there is none
+			q          Hang up
+		Replies:
+			n w h m    The size of the game now being played, after connecting, n or j
+			u x y      A move that was made, sent to everyone in the game
+			f x y
+			s x y c    After a move, each square it changed and the character g would now show for it
+			resync     Some squares changed that couldn't be sent (out of memory), so g is the only way to be sure
+			won, lost  The game is over, sent to everyone in it (after the mines it shows)
+			...-error  The command was refused (input-error, uncover-error, game-over or name-error)
+		A game starts with SAFE_START, so whoever reveals first is never unlucky.
+	*/
+
+	#define _GNU_SOURCE // For accept4()
+
+	/* Header File contains std headers, structs, other typedefs and function prototypes */
+		#include "minesweeper.h"
+
+	/* Standard Headers */
+		#include <stdlib.h>
+		#include <stdio.h>
+		#include <string.h>
+		#include <stdarg.h>
+		#include <errno.h>
+		#include <signal.h>
+
+		#include <unistd.h>
+		#include <fcntl.h>
+		#include <sys/epoll.h>
+		#include <sys/socket.h>
+		#include <sys/stat.h>
+		#include <sys/un.h>
+		#include <sys/resource.h>
+		#include <netinet/in.h>
+		#include <arpa/inet.h>
+
+	/*Macros*/
+		#define FAILED(x) ((x) != EXIT_SUCCESS) // Macro for checking if a function call did not return EXIT_SUCCESS
+		#define SERVER_LINE 256 // Longest command line. Anything longer is an input-error.
+		#define SERVER_NAME 64 // Longest name of a shared game
+		#define SERVER_MAX_SIDE 4096 // Largest field a session can ask for, so a g reply stays a few MB
+		#define SERVER_READ 4096 // Bytes taken from a socket at a time
+		#define SERVER_EVENTS 256 // Events handled per wakeup
+		#define SERVER_OUTPUT_LIMIT (64 << 20) // Replies left unread beyond this mean the client isn't listening: hang up
+		#define SERVER_OPTIONS (EXPAND_ZEROES | GENERATE_MINES | SAFE_START)
+
+	/* Type Definitions */
+		typedef struct board {
+			field Field;
+			settings Settings;
+			char* name; // What it is joined by, or NULL for a game of one's own
+			struct session* Members; // Everyone playing it, linked by nextMember
+			int over; // Set once it has been won or lost
+			struct board *next, *prev; // Neighbours in the list of games that can be joined, while it is in it
+		} board; // A game, and everyone playing it
+
+		typedef struct session {
+			int fd;
+			board* Board;
+			struct session *nextMember, *prevMember;
+			char* in; // The line being read, SERVER_LINE long. Only allocated once the client sends something.
+			size_t inLength;
+			int discarding; // Set while skipping the rest of an overlong line
+			char* out; // Replies not yet written. Freed once they all have been.
+			size_t outStart; // How much of out has been written
+			size_t outLength;
+			size_t outSize;
+			int waiting; // Set while epoll is watching for the socket to take more output
+			int pending; // Set while in the list of sessions to flush
+			int closing; // Set once it is to be freed, at the end of this wakeup
+			struct session* nextPending; // In the list of sessions to flush
+			struct session* nextClosed; // In the list of sessions to free
+		} session; // One connection
+
+		typedef struct {
+			int epoll;
+			int listener;
+			int accepting; // Cleared while out of file descriptors, until a session closes
+			settings Settings; // Size of new games, unless a session asks for another
+			const enginevariant* Engine; // Every game has SERVER_OPTIONS, so one engine plays them all
+			uint64_t masterSeed; // Each game's seed comes from this and how many games came before it
+			uint64_t games;
+			long long sessions;
+			board* Named; // Games that can be joined
+			session* Flush; // Sessions with replies to write
+			session* Closed; // Sessions to free
+			changeset Changes; // What the move being made changed. Reused for every move.
+			char* changeText; // Changes as s lines, written once and copied to each player
+			size_t changeTextSize;
+		} server;
+
+		int openListener(const char* path, int port); // Returns a listening socket on path, or 127.0.0.1:port, or -1.
+		void acceptSessions(server* Server); // Accept every connection waiting on the listener.
+		void readSession(server* Server, session* Session); // Read what has arrived, and handle each complete line.
+		void handleLine(server* Server, session* Session, char* line); // Carry out one command.
+		void makeMove(server* Server, session* Session, char command, point Point); // Reveal or flag for the session's game.
+		void sendGrid(server* Server, session* Session); // Queue the session's field, as SIMPLE_OUTPUT draws it.
+		int newGame(server* Server, session* Session, settings Settings, const char* name); /*
+			Leave the session's game for a new one of its own, or one that can be joined by name. Returns success. */
+		int joinGame(server* Server, session* Session, const char* name); /* Join the game called name,
+		                                                                     or start it. Returns success. */
+		void leaveGame(server* Server, session* Session); // Take the session out of its game, freeing it if nobody is left.
+		void unlistGame(server* Server, board* Board); // Stop Board being joined, if it could be.
+		void endGame(server* Server, board* Board, enum display Display); // Show the mines as endField() does, and stop the game.
+		void broadcastChanges(server* Server, board* Board); // Send everyone in a game the squares in Server's changes.
+		int sendLine(server* Server, session* Session, const char* fmt, ...); // Queue a reply. Returns success.
+		void broadcast(server* Server, board* Board, const char* fmt, ...); // Queue a reply to everyone in a game.
+		int reserveOutput(server* Server, session* Session, size_t length); /* Make room for length more bytes of replies,
+		                                                                       or close the session. Returns success. */
+		void flushSession(server* Server, session* Session); // Write as many replies as the socket will take.
+		void closeSession(server* Server, session* Session); // Hang up. The session leaves its game and is freed once this wakeup is done.
+		char cellChar(minepoint MinePoint); // Returns the character SIMPLE_OUTPUT draws for a square.
+
+	/*Methods*/
+
+	int main(int argc, char *argv[]) {
+		struct epoll_event Events[SERVER_EVENTS], Event;
+		struct rlimit Limit;
+		server Server;
+		session* Session;
+		const char* path = NULL;
+		long long value;
+		char* end;
+		int opt, port = -1, count, i;
+
+		memset(&Server, 0, sizeof(Server));
+		Server.Settings.fieldSize.x = 30; // Expert, unless told otherwise
+		Server.Settings.fieldSize.y = 16;
+		Server.Settings.mines = 99;
+		Server.Settings.options = SERVER_OPTIONS;
+		Server.masterSeed = randomSeed();
+		err_file = stderr;
+		while ((opt = getopt(argc, argv, "u:p:x:y:m:s:")) != -1) {
+			switch (opt) {
+				case 'u': // Listen on this Unix-domain socket
+					path = optarg;
+					break;
+				case 's': // Master seed
+					errno = 0;
+					Server.masterSeed = strtoull(optarg, &end, 0);
+					if (errno || !*optarg || *end) {
+						fprintf(stderr, "Invalid seed: %s\n", optarg);
+						exit(EXIT_FAILURE);
+					}
+					break;
+				case 'p':
+				case 'x':
+				case 'y':
+				case 'm':
+					value = strtoll(optarg, &end, 0);
+					if (*end || !*optarg || value < (opt == 'm' ? 0 : 1) || (opt != 'm' && value > (opt == 'p' ? 65535 : SERVER_MAX_SIDE))) {
+						fprintf(stderr, "Invalid value for -%c: %s\n", opt, optarg);
+						exit(EXIT_FAILURE);
+					}
+					if (opt == 'p') port = (int) value;
+					else if (opt == 'x') Server.Settings.fieldSize.x = (int) value;
+					else if (opt == 'y') Server.Settings.fieldSize.y = (int) value;
+					else Server.Settings.mines = value;
+					break;
+				default:
+					fprintf(stderr, "Usage: %s -u socket | -p port [-x width] [-y height] [-m mines] [-s seed]\n", argv[0]);
+					exit(EXIT_FAILURE);
+			}
+		}
+		if (!path == (port < 0)) {
+			fprintf(stderr, "Give one of -u socket or -p port\n");
+			exit(EXIT_FAILURE);
+		}
+		if (Server.Settings.mines >= (long long) Server.Settings.fieldSize.x * Server.Settings.fieldSize.y) {
+			fprintf(stderr, "Too many mines for a %dx%d field\n", Server.Settings.fieldSize.x, Server.Settings.fieldSize.y);
+			exit(EXIT_FAILURE);
+		}
+
+		/* A descriptor per session, so take as many as we're allowed. Writes to a closed socket are just errors. */
+		if (getrlimit(RLIMIT_NOFILE, &Limit) == 0 && Limit.rlim_cur < Limit.rlim_max) {
+			Limit.rlim_cur = Limit.rlim_max;
+			setrlimit(RLIMIT_NOFILE, &Limit);
+		}
+		signal(SIGPIPE, SIG_IGN);
+		Server.Engine = chooseEngine(Server.Settings);
+
+		if ((Server.listener = openListener(path, port)) < 0) {
+			perror("Could not listen");
+			exit(EXIT_FAILURE);
+		}
+		if ((Server.epoll = epoll_create1(EPOLL_CLOEXEC)) < 0) fatal("Could not create epoll instance", EXIT_FAILURE);
+		Event.events = EPOLLIN;
+		Event.data.ptr = NULL; // The listener
+		if (epoll_ctl(Server.epoll, EPOLL_CTL_ADD, Server.listener, &Event) < 0) fatal("Could not watch listener", EXIT_FAILURE);
+		Server.accepting = 1;
+		if (path) fprintf(stderr, "Listening on %s\n", path);
+		else fprintf(stderr, "Listening on 127.0.0.1:%d\n", port);
+
+		while (1) {
+			if ((count = epoll_wait(Server.epoll, Events, SERVER_EVENTS, -1)) < 0) {
+				if (errno == EINTR) continue;
+				fatal("epoll_wait failed", EXIT_FAILURE);
+			}
+			for (i=0; i<count; i++) {
+				if (!(Session = Events[i].data.ptr)) {
+					acceptSessions(&Server);
+					continue;
+				}
+				if (Session->closing) continue; // Hung up by something earlier in this wakeup
+				if (Events[i].events & (EPOLLERR | EPOLLHUP)) {
+					closeSession(&Server, Session);
+					continue;
+				}
+				if (Events[i].events & EPOLLIN) readSession(&Server, Session);
+				if ((Events[i].events & EPOLLOUT) && !Session->closing) flushSession(&Server, Session);
+			}
+
+			/* Write out everything this wakeup had to say, a write per session however many replies it got */
+			while ((Session = Server.Flush)) {
+				Server.Flush = Session->nextPending;
+				Session->pending = 0;
+				if (!Session->closing) flushSession(&Server, Session);
+			}
+			while ((Session = Server.Closed)) {
+				Server.Closed = Session->nextClosed;
+				leaveGame(&Server, Session); // Only now, as its game may have been in use when it hung up
+				free(Session->in);
+				free(Session->out);
+				free(Session);
+			}
+		}
+	}
+
+	int openListener(const char* path, int port) {
+		struct sockaddr_un Unix;
+		struct sockaddr_in Inet;
+		struct stat Stat;
+		int fd, on = 1;
+
+		if (path) {
+			if (strlen(path) >= sizeof(Unix.sun_path)) {
+				errno = ENAMETOOLONG;
+				return -1;
+			}
+			if (stat(path, &Stat) == 0 && S_ISSOCK(Stat.st_mode)) unlink(path); // Left behind by an earlier server
+			if ((fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0)) < 0) return -1;
+			memset(&Unix, 0, sizeof(Unix));
+			Unix.sun_family = AF_UNIX;
+			strcpy(Unix.sun_path, path);
+			if (bind(fd, (struct sockaddr*) &Unix, sizeof(Unix)) < 0) goto failed;
+		} else {
+			if ((fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0)) < 0) return -1;
+			setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+			memset(&Inet, 0, sizeof(Inet));
+			Inet.sin_family = AF_INET;
+			Inet.sin_port = htons(port);
+			Inet.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+			if (bind(fd, (struct sockaddr*) &Inet, sizeof(Inet)) < 0) goto failed;
+		}
+		if (listen(fd, SOMAXCONN) < 0) goto failed;
+		return fd;
+
+	failed:
+		close(fd);
+		return -1;
+	}
+
+	void acceptSessions(server* Server) {
+		struct epoll_event Event;
+		session* Session;
+		int fd;
+
+		while ((fd = accept4(Server->listener, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0) {
+			if (!(Session = calloc(1, sizeof(session)))) {
+				close(fd);
+				continue;
+			}
+			Session->fd = fd;
+			Server->sessions++;
+			Event.events = EPOLLIN;
+			Event.data.ptr = Session;
+			if (epoll_ctl(Server->epoll, EPOLL_CTL_ADD, fd, &Event) < 0 || FAILED(newGame(Server, Session, Server->Settings, NULL))) {
+				closeSession(Server, Session);
+			}
+		}
+		if (errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM) {
+			/* The listener stays readable until we can take the connection, so stop listening until a session closes */
+			fprintf(stderr, "Out of descriptors at %lld sessions: %s\n", Server->sessions, strerror(errno));
+			Event.events = 0;
+			Event.data.ptr = NULL;
+			epoll_ctl(Server->epoll, EPOLL_CTL_MOD, Server->listener, &Event);
+			Server->accepting = 0;
+		}
+	}
+
+	void readSession(server* Server, session* Session) {
+		char data[SERVER_READ];
+		ssize_t length, i;
+
+		if ((length = read(Session->fd, data, sizeof(data))) < 0) {
+			if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) closeSession(Server, Session);
+			return;
+		}
+		if (length == 0) {
+			closeSession(Server, Session);
+			return;
+		}
+		if (!Session->in && !(Session->in = malloc(SERVER_LINE))) {
+			closeSession(Server, Session);
+			return;
+		}
+		for (i=0; i<length && !Session->closing; i++) {
+			if (data[i] != '\n') {
+				if (Session->inLength < SERVER_LINE - 1) Session->in[Session->inLength++] = data[i];
+				else Session->discarding = 1;
+				continue;
+			}
+			if (Session->inLength && Session->in[Session->inLength - 1] == '\r') Session->inLength--;
+			Session->in[Session->inLength] = '\0';
+			if (Session->discarding) sendLine(Server, Session, "input-error");
+			else handleLine(Server, Session, Session->in);
+			Session->inLength = 0;
+			Session->discarding = 0;
+		}
+	}
+
+	void handleLine(server* Server, session* Session, char* line) {
+		settings Settings;
+		point Point;
+		long long values[3];
+		char* end;
+		int count = 0;
+
+		/* Every command is a letter and up to three numbers, except j which takes a name */
+		if (line[0] && line[0] != 'j') {
+			for (end = line + 1; count < 3; count++) {
+				while (*end == ' ' || *end == '\t') end++;
+				if (!*end) break;
+				errno = 0;
+				values[count] = strtoll(end, &end, 10);
+				if (errno || (*end && *end != ' ' && *end != '\t')) return (void) sendLine(Server, Session, "input-error");
+			}
+			while (*end == ' ' || *end == '\t') end++;
+			if (*end) return (void) sendLine(Server, Session, "input-error"); // A fourth number, or junk
+		}
+
+		switch (line[0]) {
+			case 'u': case 'f':
+				if (count != 2) break;
+				if (values[0] < 0 || values[0] >= Session->Board->Settings.fieldSize.x ||
+				    values[1] < 0 || values[1] >= Session->Board->Settings.fieldSize.y) {
+					sendLine(Server, Session, "uncover-error"); // As the SIMPLE_INPUT front-end says for a square off the field
+					return;
+				}
+				Point.x = (int) values[0];
+				Point.y = (int) values[1];
+				makeMove(Server, Session, line[0], Point);
+				return;
+			case 'g':
+				if (count) break;
+				sendGrid(Server, Session);
+				return;
+			case 'n':
+				Settings = Server->Settings;
+				if (count == 3) {
+					if (values[0] < 1 || values[0] > SERVER_MAX_SIDE || values[1] < 1 || values[1] > SERVER_MAX_SIDE ||
+					    values[2] < 0 || values[2] >= values[0] * values[1]) break;
+					Settings.fieldSize.x = (int) values[0];
+					Settings.fieldSize.y = (int) values[1];
+					Settings.mines = values[2];
+				} else if (count) break;
+				if (FAILED(newGame(Server, Session, Settings, NULL))) closeSession(Server, Session);
+				return;
+			case 'j':
+				for (line++; *line == ' ' || *line == '\t'; line++);
+				if (!*line || strlen(line) > SERVER_NAME) {
+					sendLine(Server, Session, "name-error");
+					return;
+				}
+				if (FAILED(joinGame(Server, Session, line))) closeSession(Server, Session);
+				return;
+			case 'q':
+				if (count) break;
+				closeSession(Server, Session);
+				return;
+			case '\0': // Blank lines are harmless
+				return;
+			default:
+				break;
+		}
+		sendLine(Server, Session, "input-error");
+	}
+
+	void makeMove(server* Server, session* Session, char command, point Point) {
+		board* Board = Session->Board;
+		enum display Display = (command == 'u') ? DISPLAYED : FLAGGED;
+		const char* ending = NULL;
+		int result, won = 0;
+
+		if (Board->over) {
+			sendLine(Server, Session, "game-over");
+			return;
+		}
+
+		/* Everything the move changes, down to the mines shown at the end, is recorded so it can be sent on */
+		clearChanges(&Server->Changes);
+		watchField(Board->Field, &Server->Changes);
+		if ((result = Server->Engine->setPointTo(Board->Field, Board->Settings, Point, Display)) == ENGINE_MINE && Display == DISPLAYED) {
+			endGame(Server, Board, DISPLAYED);
+			ending = "lost";
+		} else if (result >= ENGINE_MINE && (won = Server->Engine->checkWin(Board->Field, Board->Settings)) > 0) {
+			endGame(Server, Board, FLAGGED);
+			ending = "won";
+		}
+		watchField(Board->Field, NULL);
+
+		if (result < ENGINE_MINE) {
+			sendLine(Server, Session, "%s", engineError(result));
+			return;
+		}
+		broadcast(Server, Board, "%c %d %d", command, Point.x, Point.y);
+		broadcastChanges(Server, Board);
+		if (won < 0) sendLine(Server, Session, "%s", engineError(won));
+		if (ending) broadcast(Server, Board, "%s", ending);
+	}
+
+	void broadcastChanges(server* Server, board* Board) {
+		session* Member;
+		size_t length = 0, i;
+		long long offset;
+		char* text;
+		int width = Board->Settings.fieldSize.x;
+
+		if (Server->Changes.overflowed) {
+			broadcast(Server, Board, "resync");
+			return;
+		}
+		for (i=0; i<Server->Changes.length; i++) {
+			if (Server->changeTextSize - length < 32) { // Room for any line
+				if (!(text = realloc(Server->changeText, Server->changeTextSize ? Server->changeTextSize * 2 : 4096))) {
+					broadcast(Server, Board, "resync");
+					return;
+				}
+				Server->changeText = text;
+				Server->changeTextSize = Server->changeTextSize ? Server->changeTextSize * 2 : 4096;
+			}
+			offset = CHANGE_OFFSET(Server->Changes.changes[i]);
+			length += sprintf(Server->changeText + length, "s %lld %lld %c\n", offset % width, offset / width,
+			                  cellChar(CHANGE_MINEPOINT(Server->Changes.changes[i])));
+		}
+		if (!length) return;
+		for (Member = Board->Members; Member; Member = Member->nextMember) {
+			if (Member->closing || FAILED(reserveOutput(Server, Member, length))) continue;
+			memcpy(Member->out + Member->outLength, Server->changeText, length);
+			Member->outLength += length;
+		}
+	}
+
+	void sendGrid(server* Server, session* Session) {
+		board* Board = Session->Board;
+		point Point;
+		minepoint* MinePoint;
+		char* row;
+
+		for (Point.y=0; Point.y<Board->Settings.fieldSize.y; Point.y++) {
+			if (FAILED(reserveOutput(Server, Session, Board->Settings.fieldSize.x + 1))) return;
+			row = Session->out + Session->outLength;
+			for (Point.x=0; Point.x<Board->Settings.fieldSize.x; Point.x++) {
+				if (!(MinePoint = getMinepoint(Point, Board->Field, Board->Settings.fieldSize))) {
+					closeSession(Server, Session); // Out of memory for the tile
+					return;
+				}
+				row[Point.x] = cellChar(*MinePoint);
+			}
+			row[Point.x] = '\n';
+			Session->outLength += Point.x + 1;
+		}
+	}
+
+	int newGame(server* Server, session* Session, settings Settings, const char* name) {
+		board* Board;
+
+		leaveGame(Server, Session);
+		if (!(Board = calloc(1, sizeof(board)))) return EXIT_FAILURE;
+		Settings.seed = mix64(Server->masterSeed ^ mix64(Server->games++));
+		Board->Settings = Settings;
+		if (FAILED(createField(&Board->Field, Settings)) || FAILED(buildField(Board->Field, Settings, Settings.seed)) ||
+		    (name && !(Board->name = strdup(name)))) {
+			if (Board->Field) freeField(&Board->Field);
+			free(Board);
+			return EXIT_FAILURE;
+		}
+		if (name) {
+			Board->next = Server->Named;
+			if (Server->Named) Server->Named->prev = Board;
+			Server->Named = Board;
+		}
+		Session->Board = Board;
+		Board->Members = Session;
+		return sendLine(Server, Session, "n %d %d %lld", Settings.fieldSize.x, Settings.fieldSize.y, Settings.mines);
+	}
+
+	int joinGame(server* Server, session* Session, const char* name) {
+		board* Board;
+
+		for (Board = Server->Named; Board && strcmp(Board->name, name); Board = Board->next);
+		if (!Board) return newGame(Server, Session, Server->Settings, name);
+		if (Board == Session->Board) return sendLine(Server, Session, "n %d %d %lld", Board->Settings.fieldSize.x,
+		                                             Board->Settings.fieldSize.y, Board->Settings.mines);
+
+		leaveGame(Server, Session);
+		Session->Board = Board;
+		Session->nextMember = Board->Members;
+		Board->Members->prevMember = Session; // A listed game always has someone in it
+		Board->Members = Session;
+		return sendLine(Server, Session, "n %d %d %lld", Board->Settings.fieldSize.x, Board->Settings.fieldSize.y, Board->Settings.mines);
+	}
+
+	void leaveGame(server* Server, session* Session) {
+		board* Board = Session->Board;
+
+		if (!Board) return;
+		if (Session->prevMember) Session->prevMember->nextMember = Session->nextMember;
+		else Board->Members = Session->nextMember;
+		if (Session->nextMember) Session->nextMember->prevMember = Session->prevMember;
+		Session->Board = NULL;
+		Session->nextMember = Session->prevMember = NULL;
+		if (Board->Members) return;
+
+		unlistGame(Server, Board);
+		freeField(&Board->Field);
+		free(Board->name);
+		free(Board);
+	}
+
+	void unlistGame(server* Server, board* Board) {
+		if (!Board->name) return;
+		if (Board->prev) Board->prev->next = Board->next;
+		else if (Server->Named == Board) Server->Named = Board->next;
+		else return; // Already unlisted
+		if (Board->next) Board->next->prev = Board->prev;
+		Board->next = Board->prev = NULL;
+	}
+
+	void endGame(server* Server, board* Board, enum display Display) {
+		Board->over = 1;
+		endField(Board->Field, Display);
+		unlistGame(Server, Board); // Joining it by name starts a new one
+	}
+
+	int sendLine(server* Server, session* Session, const char* fmt, ...) {
+		va_list args;
+		int length;
+
+		va_start(args, fmt);
+		length = vsnprintf(NULL, 0, fmt, args);
+		va_end(args);
+		if (length < 0 || FAILED(reserveOutput(Server, Session, length + 2))) return EXIT_FAILURE; // vsnprintf() writes a nul
+		va_start(args, fmt);
+		vsnprintf(Session->out + Session->outLength, length + 1, fmt, args);
+		va_end(args);
+		Session->out[Session->outLength + length] = '\n';
+		Session->outLength += length + 1;
+		return EXIT_SUCCESS;
+	}
+
+	void broadcast(server* Server, board* Board, const char* fmt, ...) {
+		session* Member;
+		char line[SERVER_LINE];
+		va_list args;
+
+		va_start(args, fmt);
+		vsnprintf(line, sizeof(line), fmt, args);
+		va_end(args);
+		for (Member = Board->Members; Member; Member = Member->nextMember) {
+			if (!Member->closing) sendLine(Server, Member, "%s", line);
+		}
+	}
+
+	int reserveOutput(server* Server, session* Session, size_t length) {
+		size_t size;
+		char* out;
+
+		if (Session->closing) return EXIT_FAILURE;
+		if (!Session->pending) {
+			/* Written at the end of the wakeup, with anything else it gets */
+			Session->pending = 1;
+			Session->nextPending = Server->Flush;
+			Server->Flush = Session;
+		}
+		if (Session->outLength + length <= Session->outSize) return EXIT_SUCCESS;
+		if (Session->outStart) {
+			/* Move what's left to the front first, in case that's room enough */
+			memmove(Session->out, Session->out + Session->outStart, Session->outLength - Session->outStart);
+			Session->outLength -= Session->outStart;
+			Session->outStart = 0;
+			if (Session->outLength + length <= Session->outSize) return EXIT_SUCCESS;
+		}
+		if (Session->outLength + length > SERVER_OUTPUT_LIMIT) {
+			closeSession(Server, Session);
+			return EXIT_FAILURE;
+		}
+		for (size = Session->outSize ? Session->outSize * 2 : 256; size < Session->outLength + length; size *= 2);
+		if (!(out = realloc(Session->out, size))) {
+			closeSession(Server, Session);
+			return EXIT_FAILURE;
+		}
+		Session->out = out;
+		Session->outSize = size;
+		return EXIT_SUCCESS;
+	}
+
+	void flushSession(server* Server, session* Session) {
+		struct epoll_event Event;
+		ssize_t written;
+
+		while (Session->outStart < Session->outLength) {
+			written = send(Session->fd, Session->out + Session->outStart, Session->outLength - Session->outStart, MSG_NOSIGNAL);
+			if (written < 0 && errno == EINTR) continue;
+			if (written < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+			if (written < 0) {
+				closeSession(Server, Session);
+				return;
+			}
+			Session->outStart += written;
+		}
+		if (Session->outStart == Session->outLength) {
+			/* Idle sessions are most of them, so they don't keep a buffer */
+			free(Session->out);
+			Session->out = NULL;
+			Session->outStart = Session->outLength = Session->outSize = 0;
+		}
+
+		/* Only ask to hear when the socket has room while there's something waiting for it */
+		if (Session->waiting != (Session->outLength != 0)) {
+			Session->waiting = (Session->outLength != 0);
+			Event.events = EPOLLIN | (Session->waiting ? EPOLLOUT : 0);
+			Event.data.ptr = Session;
+			if (epoll_ctl(Server->epoll, EPOLL_CTL_MOD, Session->fd, &Event) < 0) closeSession(Server, Session);
+		}
+	}
+
+	void closeSession(server* Server, session* Session) {
+		struct epoll_event Event;
+
+		if (Session->closing) return;
+		Session->closing = 1;
+		close(Session->fd); // Which takes it out of the epoll set too
+		Server->sessions--;
+		/* It may still be in the flush list, due an event this wakeup, or in a game being broadcast to,
+		   so it leaves its game and is freed once the wakeup is done */
+		Session->nextClosed = Server->Closed;
+		Server->Closed = Session;
+
+		if (!Server->accepting) {
+			/* There's a descriptor free now */
+			Event.events = EPOLLIN;
+			Event.data.ptr = NULL;
+			if (epoll_ctl(Server->epoll, EPOLL_CTL_MOD, Server->listener, &Event) == 0) Server->accepting = 1;
+		}
+	}
+
+	char cellChar(minepoint MinePoint) {
+		switch (getDisplay(MinePoint)) {
+			case HIDDEN: return '*';
+			case FLAGGED: return 'f';
+			default: return isMine(MinePoint) ? 'X' : '0' + getValue(MinePoint);
+		}
+	}
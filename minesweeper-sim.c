@@ -0,0 +1,262 @@
+	/*
+		Batch self-play simulator.
+		Plays the solver through many generated fields of one size across all cores,
+		to evaluate field settings by their win rate.
+		Each worker thread owns its own solver and fields, and keeps its own statistics,
+		which are merged once every game is done.
+		Games are handed out by index from per-worker ranges; a worker that runs out steals
+		half of what another has left. Each game's seed comes from the master seed and the
+		game's index alone, so results do not depend on the number of threads.
+	*/
+
+	/* Header File contains solver structs and function prototypes (and includes the engine's) */
+		#include "solver.h"
+
+	/* Standard Headers */
+		#include <stdlib.h>
+		#include <stdio.h>
+		#include <errno.h>
+		#include <inttypes.h>
+		#include <time.h>
+		#include <unistd.h>
+		#include <pthread.h>
+
+	/*Macros*/
+		#define FAILED(x) ((x) != EXIT_SUCCESS) // Macro for checking if a function call did not return EXIT_SUCCESS
+		#define MAX_THREADS 1024
+
+	/* Type Definitions */
+		typedef struct {
+			long long games;
+			long long wins;
+			long long clicks;
+			long long guesses;
+			long long revealed;
+			long long nanoseconds; // Total time spent in games
+			long long slowest; // Longest single game, in nanoseconds
+		} simstats;
+
+		typedef struct simworker {
+			_Alignas(64) pthread_mutex_t lock; // Guards next and end, which other workers may steal from
+			long long next; // Next game index this worker will play
+			long long end; // One past the last game index this worker owns
+			int index;
+			int workers;
+			struct simworker* Workers;
+			settings Settings;
+			uint64_t masterSeed;
+			int failed; // Set if the solver or engine reported an error
+			simstats Stats;
+			pthread_t thread;
+		} simworker; // One thread's share of the games. Aligned so workers' stats don't share cache lines.
+
+		void* runWorker(void* arg); // Thread body: play games until there are none left anywhere.
+		int takeGame(simworker* Worker, long long* game); // Claim a game from Worker's own range. Returns 1 if one was claimed.
+		int stealGames(simworker* Worker); // Move half of another worker's remaining games to Worker. Returns 1 if any were found.
+		void mergeStats(simstats* Total, const simstats* Stats); // Add Stats into Total.
+		long long elapsed(const struct timespec* start, const struct timespec* stop); // Nanoseconds between start and stop.
+
+	/*Methods*/
+
+	int main(int argc, char *argv[]) {
+		int opt, i, threads = 0, verbose = 0;
+		long long games = 100000, value;
+		uint64_t masterSeed = 0x5EEDULL;
+		char* end;
+		struct timespec start, stop;
+		double seconds;
+		simstats Total = {0};
+		simworker* Workers;
+		settings Settings = {{30, 16}, 99, EXPAND_ZEROES | GENERATE_MINES, 0}; // Expert, unless told otherwise
+
+		err_file = stderr;
+		while ((opt = getopt(argc, argv, "n:j:x:y:m:s:v")) != -1) {
+			switch (opt) {
+				case 's': // Master seed
+					errno = 0;
+					masterSeed = strtoull(optarg, &end, 0);
+					if (errno || !*optarg || *end) {
+						fprintf(stderr, "Invalid seed: %s\n", optarg);
+						exit(EXIT_FAILURE);
+					}
+					break;
+				case 'v': // Per-thread statistics as well
+					verbose = 1;
+					break;
+				case 'n':
+				case 'j':
+				case 'x':
+				case 'y':
+				case 'm':
+					value = strtoll(optarg, &end, 0);
+					if (*end || !*optarg || value < (opt == 'm' ? 0 : 1) || (opt != 'n' && opt != 'm' && value > (opt == 'j' ? MAX_THREADS : 30000))) {
+						fprintf(stderr, "Invalid value for -%c: %s\n", opt, optarg);
+						exit(EXIT_FAILURE);
+					}
+					if (opt == 'n') games = value;
+					else if (opt == 'j') threads = (int) value;
+					else if (opt == 'x') Settings.fieldSize.x = (int) value;
+					else if (opt == 'y') Settings.fieldSize.y = (int) value;
+					else Settings.mines = value;
+					break;
+				default:
+					fprintf(stderr, "Usage: %s [-n games] [-j threads] [-x width] [-y height] [-m mines] [-s seed] [-v]\n", argv[0]);
+					exit(EXIT_FAILURE);
+			}
+		}
+		if (Settings.mines >= (long long) Settings.fieldSize.x * Settings.fieldSize.y) {
+			fprintf(stderr, "Too many mines for a %dx%d field\n", Settings.fieldSize.x, Settings.fieldSize.y);
+			exit(EXIT_FAILURE);
+		}
+		if (!threads) {
+			value = sysconf(_SC_NPROCESSORS_ONLN);
+			threads = (value < 1) ? 1 : (value > MAX_THREADS) ? MAX_THREADS : (int) value;
+		}
+		if (threads > games) threads = (int) games;
+
+		if (!(Workers = aligned_alloc(_Alignof(simworker), threads * sizeof(simworker)))) fatal("Out of memory", EXIT_FAILURE);
+		for (i=0; i<threads; i++) {
+			/* Split the games evenly to start with; stealing evens out the rest */
+			pthread_mutex_init(&Workers[i].lock, NULL);
+			Workers[i].next = games * i / threads;
+			Workers[i].end = games * (i+1) / threads;
+			Workers[i].index = i;
+			Workers[i].workers = threads;
+			Workers[i].Workers = Workers;
+			Workers[i].Settings = Settings;
+			Workers[i].masterSeed = masterSeed;
+			Workers[i].failed = 0;
+			Workers[i].Stats = Total;
+		}
+
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		for (i=0; i<threads; i++) {
+			if (pthread_create(&Workers[i].thread, NULL, runWorker, &Workers[i])) fatal("Could not start worker thread", EXIT_FAILURE);
+		}
+		for (i=0; i<threads; i++) pthread_join(Workers[i].thread, NULL);
+		clock_gettime(CLOCK_MONOTONIC, &stop);
+		seconds = elapsed(&start, &stop) / 1e9;
+
+		for (i=0; i<threads; i++) {
+			if (Workers[i].failed) fatal("Solver failed during simulation", EXIT_FAILURE);
+			mergeStats(&Total, &Workers[i].Stats);
+			if (verbose) {
+				printf("thread %-4d %10lld games %8.2f%% won %12.1f us/game\n", i, Workers[i].Stats.games,
+				       Workers[i].Stats.games ? 100.0 * Workers[i].Stats.wins / Workers[i].Stats.games : 0.0,
+				       Workers[i].Stats.games ? Workers[i].Stats.nanoseconds / 1e3 / Workers[i].Stats.games : 0.0);
+			}
+			pthread_mutex_destroy(&Workers[i].lock);
+		}
+		free(Workers);
+
+		printf("field        %dx%d, %lld mines\n", Settings.fieldSize.x, Settings.fieldSize.y, Settings.mines);
+		printf("threads      %d\n", threads);
+		printf("games        %lld\n", Total.games);
+		printf("won          %.2f%%\n", 100.0 * Total.wins / Total.games);
+		printf("clicks       %.2f per game\n", (double) Total.clicks / Total.games);
+		printf("guesses      %.2f per game\n", (double) Total.guesses / Total.games);
+		printf("revealed     %.2f per game\n", (double) Total.revealed / Total.games);
+		printf("time         %.1f us per game (slowest %.1f us)\n", Total.nanoseconds / 1e3 / Total.games, Total.slowest / 1e3);
+		printf("throughput   %.1f games/s (%.3f s)\n", Total.games / seconds, seconds);
+		exit(EXIT_SUCCESS);
+	}
+
+	void* runWorker(void* arg) {
+		simworker* Worker = arg;
+		settings Settings = Worker->Settings;
+		solvestats GameStats;
+		struct timespec start, stop;
+		long long game, nanoseconds;
+		field Field;
+		solver* Solver;
+		point First;
+		int result;
+
+		err_file = stderr;
+		First.x = Settings.fieldSize.x / 2;
+		First.y = Settings.fieldSize.y / 2;
+		if (FAILED(createSolver(&Solver, Settings.fieldSize))) {
+			Worker->failed = 1;
+			return NULL;
+		}
+
+		while (takeGame(Worker, &game) || (stealGames(Worker) && takeGame(Worker, &game))) {
+			clock_gettime(CLOCK_MONOTONIC, &start);
+			Settings.seed = mix64(Worker->masterSeed ^ mix64((uint64_t) game));
+			if (FAILED(createField(&Field, Settings)) || FAILED(buildField(Field, Settings, Settings.seed))) {
+				freeField(&Field);
+				Worker->failed = 1;
+				break;
+			}
+			result = solveGame(Solver, Field, Settings, First, &GameStats);
+			freeField(&Field);
+			clock_gettime(CLOCK_MONOTONIC, &stop);
+			if (result < 0) {
+				fprintf(stderr, "Solver failed on seed 0x%016" PRIx64 "\n", Settings.seed);
+				Worker->failed = 1;
+				break;
+			}
+
+			nanoseconds = elapsed(&start, &stop);
+			Worker->Stats.games++;
+			Worker->Stats.wins += result;
+			Worker->Stats.clicks += GameStats.clicks;
+			Worker->Stats.guesses += GameStats.guesses;
+			Worker->Stats.revealed += GameStats.revealed;
+			Worker->Stats.nanoseconds += nanoseconds;
+			if (nanoseconds > Worker->Stats.slowest) Worker->Stats.slowest = nanoseconds;
+		}
+
+		freeSolver(&Solver);
+		return NULL;
+	}
+
+	int takeGame(simworker* Worker, long long* game) {
+		int found = 0;
+		pthread_mutex_lock(&Worker->lock);
+		if (Worker->next < Worker->end) {
+			*game = Worker->next++;
+			found = 1;
+		}
+		pthread_mutex_unlock(&Worker->lock);
+		return found;
+	}
+
+	int stealGames(simworker* Worker) {
+		simworker* Workers = Worker->Workers;
+		simworker* Victim;
+		long long next, end;
+		int i;
+
+		for (i=1; i<Worker->workers; i++) {
+			Victim = &Workers[(Worker->index + i) % Worker->workers];
+			/* Take the far half, so the victim can carry on from where it is */
+			pthread_mutex_lock(&Victim->lock);
+			end = Victim->end;
+			next = end - (end - Victim->next) / 2;
+			if (next < end) Victim->end = next;
+			pthread_mutex_unlock(&Victim->lock);
+			if (next >= end) continue; // Nothing worth stealing
+
+			pthread_mutex_lock(&Worker->lock);
+			Worker->next = next;
+			Worker->end = end;
+			pthread_mutex_unlock(&Worker->lock);
+			return 1;
+		}
+		return 0;
+	}
+
+	void mergeStats(simstats* Total, const simstats* Stats) {
+		Total->games += Stats->games;
+		Total->wins += Stats->wins;
+		Total->clicks += Stats->clicks;
+		Total->guesses += Stats->guesses;
+		Total->revealed += Stats->revealed;
+		Total->nanoseconds += Stats->nanoseconds;
+		if (Stats->slowest > Total->slowest) Total->slowest = Stats->slowest;
+	}
+
+	long long elapsed(const struct timespec* start, const struct timespec* stop) {
+		return (long long) (stop->tv_sec - start->tv_sec) * 1000000000LL + (stop->tv_nsec - start->tv_nsec);
+	}
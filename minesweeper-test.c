@@ -0,0 +1,295 @@
+	/*
+		Engine checks.
+		Each check plays many generated fields and compares what the engine keeps against a count
+		from scratch. Prints a line per check, and exits with failure if any of them failed.
+	*/
+
+	/* Header File contains std headers, structs, other typedefs and function prototypes */
+		#include "minesweeper.h"
+
+	/* Standard Headers */
+		#include <stdlib.h>
+		#include <stdio.h>
+		#include <string.h>
+		#include <stddef.h>
+		#include <unistd.h>
+
+	/*Macros*/
+		#define FAILED(x) ((x) != EXIT_SUCCESS) // Macro for checking if a function call did not return EXIT_SUCCESS
+		#define SEEDS 200 // Fields each check plays
+		#define MOVES 40 // Most random moves made on a field before it is saved
+
+	/* Prototypes */
+		int checkFirstReveal(void); /* SAFE_START fields, with some tiles drawn before a first reveal next to a tile
+		                               boundary: every value must match minesAround(), the opening must be clear and
+		                               no mines lost. Returns how many fields weren't right. */
+		int checkTiles(field Field); // Returns how many squares in Field's tiles have a value that doesn't match minesAround().
+		long long countMines(field Field, settings Settings); // Returns how many mines Field has, made or not.
+		int checkSnapshots(void); /* Part-played fields, saved and loaded back: every square and counter must match, and
+		                             the snapshot must be refused once truncated or corrupted. Returns how many fields
+		                             weren't right. */
+		int checkJournal(void); /* Part-played games, journalled two to a file and replayed: each game whole, and the first
+		                           up to a move part way through, must match a field given the same moves.
+		                           Returns how many journals weren't right. */
+		int playMoves(field Field, settings Settings, rng* Rng, int moves, journal* Journal); /* Make up to moves random
+			reveals and flags, chosen from Rng alone, recording them in Journal unless it is NULL. Stops at a mine.
+			Returns the number made, or -1 on error. */
+		int compareFields(field A, field B, settings Settings); // Returns how many squares and counters differ between A and B.
+		int refused(const char* path, const void* data, size_t length); /* Write data to path as a snapshot. Returns 1 if
+		                                                                    loadField() refuses it and leaves its arguments
+		                                                                    alone, else 0. */
+
+	/*Methods*/
+
+	int main(void) {
+		int failures, failed = 0;
+
+		err_file = stderr;
+		failures = checkFirstReveal();
+		printf("first_reveal %s (%d of %d fields wrong)\n", failures ? "FAILED" : "ok", failures, SEEDS);
+		failed |= failures;
+		failures = checkSnapshots();
+		printf("snapshots %s (%d of %d fields wrong)\n", failures ? "FAILED" : "ok", failures, SEEDS);
+		failed |= failures;
+		failures = checkJournal();
+		printf("journal %s (%d of %d journals wrong)\n", failures ? "FAILED" : "ok", failures, SEEDS);
+		failed |= failures;
+
+		exit(failed ? EXIT_FAILURE : EXIT_SUCCESS);
+	}
+
+	int checkFirstReveal(void) {
+		settings Settings = {{128, 64}, 2000, GENERATE_MINES | SAFE_START, 0};
+		point Reveal, Drawn;
+		field Field;
+		rng Rng;
+		int seed, failures = 0, wrong, dx, dy;
+
+		for (seed = 0; seed < SEEDS; seed++) {
+			rngSeed(&Rng, mix64((uint64_t) seed));
+			if (FAILED(createField(&Field, Settings)) || FAILED(buildField(Field, Settings, (uint64_t) seed))) fatal("Could not create field", EXIT_FAILURE);
+
+			/* Draw one or two tiles, as the display would, then reveal within a square of the corner they share */
+			Drawn.x = rngBelow(&Rng, 2) << TILE_SHIFT;
+			Drawn.y = 0;
+			if (!getMinepoint(Drawn, Field, Settings.fieldSize)) fatal("Out of memory", EXIT_FAILURE);
+			if (rngBelow(&Rng, 2)) {
+				Drawn.x ^= TILE_SIZE;
+				if (!getMinepoint(Drawn, Field, Settings.fieldSize)) fatal("Out of memory", EXIT_FAILURE);
+			}
+			Reveal.x = TILE_SIZE - 2 + rngBelow(&Rng, 4);
+			Reveal.y = rngBelow(&Rng, Settings.fieldSize.y);
+			if (setPointTo(Field, Settings, Reveal, DISPLAYED) < 0) fatal("Could not reveal", EXIT_FAILURE);
+
+			wrong = checkTiles(Field) + (countMines(Field, Settings) != Settings.mines);
+			for (dy=-1; dy<=1; dy++) for (dx=-1; dx<=1; dx++) {
+				Drawn.x = Reveal.x + dx;
+				Drawn.y = Reveal.y + dy;
+				if (Drawn.x < 0 || Drawn.y < 0 || Drawn.y >= Settings.fieldSize.y) continue;
+				wrong += isMine(*getMinepoint(Drawn, Field, Settings.fieldSize)); // The opening must be clear
+			}
+			if (checkState(Field, Settings) < 0) wrong++;
+			failures += (wrong != 0);
+			freeField(&Field);
+		}
+		return failures;
+	}
+
+	int checkTiles(field Field) {
+		point Size, Point, Square;
+		minepoint MinePoint;
+		size_t i;
+		int wrong = 0;
+
+		for (i=0; i<Field->tileSlots; i++) {
+			if (!Field->tiles[i]) continue;
+			Size = getTileSize(Field, Field->tiles[i]->Position);
+			for (Point.y=0; Point.y<Size.y; Point.y++) for (Point.x=0; Point.x<Size.x; Point.x++) {
+				MinePoint = Field->tiles[i]->points[(Point.y << TILE_SHIFT) | Point.x];
+				if (isMine(MinePoint)) continue;
+				Square.x = (Field->tiles[i]->Position.x << TILE_SHIFT) | Point.x;
+				Square.y = (Field->tiles[i]->Position.y << TILE_SHIFT) | Point.y;
+				wrong += (getValue(MinePoint) != minesAround(Field, Square));
+			}
+		}
+		return wrong;
+	}
+
+	long long countMines(field Field, settings Settings) {
+		uint64_t rows[TILE_SIZE];
+		point Position;
+		long long mines = 0;
+		int i;
+
+		for (Position.y = 0; Position.y << TILE_SHIFT < Settings.fieldSize.y; Position.y++)
+		for (Position.x = 0; Position.x << TILE_SHIFT < Settings.fieldSize.x; Position.x++) {
+			tileMines(Field, Position, rows);
+			for (i=0; i<TILE_SIZE; i++) mines += __builtin_popcountll(rows[i]);
+		}
+		return mines;
+	}
+
+	int checkSnapshots(void) {
+		settings Settings = {{300, 200}, 6000, GENERATE_MINES | EXPAND_ZEROES, 0}, Loaded;
+		snapshotheader Header, Saved;
+		field Field, Copy;
+		rng Rng;
+		char path[64];
+		unsigned char* data;
+		FILE* file;
+		long length;
+		int seed, failures = 0, wrong;
+
+		snprintf(path, sizeof(path), "/tmp/minesweeper-test-%d.snapshot", (int) getpid());
+		for (seed = 0; seed < SEEDS; seed++) {
+			Settings.options = GENERATE_MINES | EXPAND_ZEROES | ((seed & 1) ? SAFE_START : 0);
+			Settings.seed = mix64((uint64_t) seed);
+			rngSeed(&Rng, Settings.seed);
+			if (FAILED(createField(&Field, Settings)) || FAILED(buildField(Field, Settings, Settings.seed))) fatal("Could not create field", EXIT_FAILURE);
+			if (playMoves(Field, Settings, &Rng, rngBelow(&Rng, MOVES + 1), NULL) < 0) fatal("Could not play", EXIT_FAILURE);
+
+			/* It must come back just as it was */
+			if (FAILED(saveField(Field, Settings, path)) || FAILED(loadField(&Copy, &Loaded, path))) {
+				failures++;
+				freeField(&Field);
+				continue;
+			}
+			wrong = Loaded.fieldSize.x != Settings.fieldSize.x || Loaded.fieldSize.y != Settings.fieldSize.y ||
+			        Loaded.mines != Settings.mines || Loaded.options != Settings.options || Loaded.seed != Settings.seed;
+			wrong += compareFields(Field, Copy, Settings);
+			freeField(&Copy);
+
+			/* And be refused whole once damaged */
+			if (!(file = fopen(path, "rb")) || fseek(file, 0, SEEK_END) || (length = ftell(file)) < (long) sizeof(Header) ||
+			    fseek(file, 0, SEEK_SET) || !(data = malloc(length)) || fread(data, 1, length, file) != (size_t) length) fatal("Could not read snapshot", EXIT_FAILURE);
+			fclose(file);
+			memcpy(&Saved, data, sizeof(Saved));
+			wrong += !refused(path, data, length - 1); // Part of a tile missing
+			wrong += !refused(path, data, sizeof(Header) / 2); // Part of the header missing
+			data[0] ^= 0xFF;
+			wrong += !refused(path, data, length); // Not a snapshot
+			data[0] ^= 0xFF;
+			Header = Saved;
+			Header.correctFlags = Header.flagged + 1;
+			memcpy(data, &Header, sizeof(Header));
+			wrong += !refused(path, data, length); // Counters that can't be right
+			Header = Saved;
+			Header.hidden = (int64_t) Settings.fieldSize.x * Settings.fieldSize.y + 1;
+			memcpy(data, &Header, sizeof(Header));
+			wrong += !refused(path, data, length);
+			memcpy(data, &Saved, sizeof(Saved));
+			if (Saved.tileCount) {
+				data[sizeof(Saved) + offsetof(tile, points)] = 12; // Not a value a square can have
+				wrong += !refused(path, data, length);
+			}
+			free(data);
+			unlink(path);
+			failures += (wrong != 0);
+			freeField(&Field);
+		}
+		return failures;
+	}
+
+	int checkJournal(void) {
+		settings Settings[2], Replayed;
+		field Played[2], Field, Again;
+		replayinfo Info;
+		journal Journal;
+		rng Rng;
+		char path[64];
+		uint64_t start[2];
+		int seed, failures = 0, wrong, made[2], game, part;
+
+		snprintf(path, sizeof(path), "/tmp/minesweeper-test-%d.journal", (int) getpid());
+		for (seed = 0; seed < SEEDS; seed++) {
+			unlink(path);
+			if (FAILED(openJournal(&Journal, path))) fatal("Could not open journal", EXIT_FAILURE);
+			for (game = 0; game < 2; game++) {
+				Settings[game].fieldSize.x = 200 + 40 * game; // Differently sized, so mixing up the games shows
+				Settings[game].fieldSize.y = 150;
+				Settings[game].mines = 3000;
+				Settings[game].options = GENERATE_MINES | EXPAND_ZEROES | (game ? 0 : SAFE_START);
+				Settings[game].seed = mix64((uint64_t) seed * 2 + game);
+				start[game] = mix64(Settings[game].seed);
+				rngSeed(&Rng, start[game]);
+				if (FAILED(createField(&Played[game], Settings[game])) || FAILED(buildField(Played[game], Settings[game], Settings[game].seed)) ||
+				    FAILED(journalGame(&Journal, Settings[game])) ||
+				    (made[game] = playMoves(Played[game], Settings[game], &Rng, rngBelow(&Rng, MOVES + 1), &Journal)) < 0) fatal("Could not play", EXIT_FAILURE);
+			}
+			if (FAILED(closeJournal(&Journal))) fatal("Could not write journal", EXIT_FAILURE);
+
+			/* Each game replayed in full must end up where it was left */
+			wrong = 0;
+			for (game = 0; game < 2; game++) {
+				if (FAILED(replayJournal(path, game + 1, -1, &Field, &Replayed, &Info))) {
+					wrong++;
+					continue;
+				}
+				wrong += Replayed.fieldSize.x != Settings[game].fieldSize.x || Replayed.fieldSize.y != Settings[game].fieldSize.y ||
+				         Replayed.mines != Settings[game].mines || Replayed.options != Settings[game].options || Replayed.seed != Settings[game].seed;
+				wrong += (Info.moves != made[game]) + (Info.applied != made[game]);
+				wrong += compareFields(Played[game], Field, Settings[game]);
+				freeField(&Field);
+			}
+
+			/* And the first, stopped part way, where the same moves leave a fresh field */
+			part = made[0] / 2;
+			rngSeed(&Rng, start[0]);
+			rngBelow(&Rng, MOVES + 1); // As drawn for the number of moves
+			if (FAILED(createField(&Again, Settings[0])) || FAILED(buildField(Again, Settings[0], Settings[0].seed)) ||
+			    playMoves(Again, Settings[0], &Rng, part, NULL) != part) fatal("Could not play", EXIT_FAILURE);
+			if (FAILED(replayJournal(path, 1, part, &Field, &Replayed, &Info))) wrong++;
+			else {
+				wrong += (Info.moves != made[0]) + (Info.applied != part);
+				wrong += compareFields(Again, Field, Settings[0]);
+				freeField(&Field);
+			}
+			freeField(&Again);
+			for (game = 0; game < 2; game++) freeField(&Played[game]);
+			failures += (wrong != 0);
+		}
+		unlink(path);
+		return failures;
+	}
+
+	int playMoves(field Field, settings Settings, rng* Rng, int moves, journal* Journal) {
+		point Point;
+		enum display Display;
+		int made, result;
+
+		for (made = 0; made < moves; made++) {
+			Point.x = rngBelow(Rng, Settings.fieldSize.x);
+			Point.y = rngBelow(Rng, Settings.fieldSize.y);
+			Display = rngBelow(Rng, 4) ? DISPLAYED : FLAGGED;
+			if ((result = setPointTo(Field, Settings, Point, Display)) < ENGINE_MINE) return -1;
+			if (Journal && FAILED(journalMove(Journal, (Display == FLAGGED) ? JOURNAL_FLAG : JOURNAL_REVEAL, Point))) return -1;
+			if (result == ENGINE_MINE && Display == DISPLAYED) return made + 1;
+		}
+		return made;
+	}
+
+	int compareFields(field A, field B, settings Settings) {
+		point Point;
+		minepoint *PointA, *PointB;
+		int wrong;
+
+		wrong = (A->State.hidden != B->State.hidden) + (A->State.flagged != B->State.flagged) +
+		        (A->State.correctFlags != B->State.correctFlags) + (A->ending != B->ending) + (A->pending != B->pending) +
+		        (A->safe.x != B->safe.x) + (A->safe.y != B->safe.y);
+		for (Point.y=0; Point.y<Settings.fieldSize.y; Point.y++) for (Point.x=0; Point.x<Settings.fieldSize.x; Point.x++) {
+			PointA = getMinepoint(Point, A, Settings.fieldSize);
+			PointB = getMinepoint(Point, B, Settings.fieldSize);
+			if (!PointA || !PointB) fatal("Out of memory", EXIT_FAILURE);
+			wrong += (*PointA != *PointB);
+		}
+		return wrong;
+	}
+
+	int refused(const char* path, const void* data, size_t length) {
+		settings Settings = {{-1, -1}, -1, 0, 0};
+		field Field = NULL;
+		FILE* file;
+
+		if (!(file = fopen(path, "wb")) || fwrite(data, 1, length, file) != length || fclose(file)) fatal("Could not write snapshot", EXIT_FAILURE);
+		return FAILED(loadField(&Field, &Settings, path)) && !Field && Settings.mines == -1;
+	}
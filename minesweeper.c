@@ -2,9 +2,9 @@
 	/*
 		General TODOs and feature ideas
 			Big:
-				Multiplayer
+				Multiplayer across machines (minesweeper-server only listens locally)
 			Medium:
-				Better screen drawing method (no flicker)
+				...
 			Small:
 				...
 	*/
@@ -28,27 +28,44 @@
 		#include <string.h>
 		#include <limits.h>
 		#include <time.h>
+		#include <stdarg.h>
+		#include <errno.h>
+		#include <inttypes.h>
+		#include <ctype.h>
 
 		#include <termios.h>
 		#include <unistd.h>
 		#include <sys/ioctl.h>
+		#include <poll.h>
+		#include <signal.h>
 
 	/*Macros*/
 		#define FAILED(x) ((x) != EXIT_SUCCESS) // Macro for checking if a function call did not return EXIT_SUCCESS
 		#define STRING_LENGTH (128) // Max string length in a variety of situations
+		#define IN_BLOCK (64 * 1024) // How much SIMPLE_INPUT to read at once
+		#define KEY_BLOCK 4096 // How much interactive input to read at once
+		#define MINIMAP_WIDTH 32 // Most columns the minimap may take
+		#define MINIMAP_HEIGHT 12 // Most rows the minimap may take
 		#define MAX(x,y) ((x)>(y))?(x):(y) // Warning: Do not use with things with side-effects!
 		#define MIN(x,y) ((x)<(y))?(x):(y) // Warning: Do not use with things with side-effects!
 
+	/* Type Definitions */
+		/* The drawing functions, following the RENDER_OPTIONS in options rather than in Settings */
+		SPECIALISED int simpleDisplayAs(field Field, const settings* Settings, unsigned int options);
+		SPECIALISED int newDisplayAs(field Field, const settings* Settings, point Cursor, unsigned int options);
+		SPECIALISED const char** screenStrAs(field Field, const settings* Settings, point Point, unsigned int options);
+		SPECIALISED const char** borderStrAs(point Point, point Size, unsigned int options);
+
 	/*Global Variables*/
 		struct termios oldtermios; // for storing old termios settings - must be global to use atexit
 
 		/* Constants */
 			const point MinSize = {1, 1};
-			const point MaxSize = {200, 200};
-			const int MinMines = 0;
-			const int MaxMines = 500000;
-			const float defaultMineRatio = 0.1; // Sets default mines as this * num of minepoints
-			const settings DefaultSettings = {{20, 20}, -1, 0}; // Defaults: {20,20} field with mines set later and no options set.
+			const point MaxSize = {1000000, 1000000};
+			const long long MinMines = 0;
+			const long long MaxMines = 999999999999LL;
+			const double defaultMineRatio = 0.1; // Sets default mines as this * num of minepoints
+			const settings DefaultSettings = {{20, 20}, -1, 0, 0}; // Defaults: {20,20} field with mines set later, no options set and a random seed.
 
 			/* Arrays of (string,string) of form (fmt, str) (fmt includes escape sequences for colour, etc) for each minepoint display value. */
 				const char* displayString_OffField[2] = {"", " "};
@@ -71,7 +88,30 @@
 					/* Horiz */ {BOLD FORECOLOUR(WHITE), "-"},
 					/* Cornr */ {BOLD FORECOLOUR(WHITE), "+"}
 				};
-				FILE* err_file;
+				const char* displayString_Block[3][2] = { // Zoomed out, for a block of squares that is
+					/* Hidden  */ {FORECOLOUR(WHITE), "*"},
+					/* Partly  */ {FORECOLOUR(CYAN), "+"},
+					/* Cleared */ {FORECOLOUR(WHITE), "."}
+				};
+
+			/* Shadow screen for new_display(): what we last drew in each terminal cell, and where the field was. */
+				screencell* screenBuffer = NULL;
+				point screenBufferSize = {-1, -1};
+				point screenTopLeft; // Field coordinate (of a block, when zoomed out) shown in the top-left terminal cell
+				int zoom = 0; // Each terminal cell shows a 2^zoom block of squares
+				int screenZoom = 0; // The zoom screenTopLeft is for
+				int minimap = 1; // Whether to draw the minimap when the field doesn't fit on the screen
+				point terminalSize = {-1, -1}; // Last size getScreenSize() got from the terminal
+				volatile sig_atomic_t screenResized = 1; // Set on SIGWINCH, so terminalSize is out of date
+
+			outbuffer frameBuffer = {NULL, 0, 0, NULL, 0}; // Every frame is composed here, then written out in one go
+			const char* snapshotPath = "minesweeper.snapshot"; // Where the S and L keys save and load the game
+			journal gameJournal = {-1, NULL, 0, 0}; // Games and moves are recorded here with -j
+			inbuffer protocolIn = {NULL, 0, 0, 0, 0}; // SIMPLE_INPUT comes through here. Its output goes to frameBuffer.
+			inbuffer keyIn = {NULL, 0, 0, 0, 0}; // Keystrokes for play(), taken in a frame's worth at a time
+			int frameRate = 60; // Most frames a second play() will draw, or 0 for as many as keys come in
+			const enginevariant* Engine; // Rules the game is played by, chosen by main() for its options
+			renderer Renderer = drawFrame; // How display() draws, chosen by main() for its options (see chooseRenderer())
 
 			const char* helpString =
 				"There are several mines hidden throughout the field.\n"
@@ -82,6 +122,9 @@
 				"If you reveal a mine, you lose. Instead, Flag the mine with F.\n"
 				"This will stop you hitting the square you think is a mine. Press F again to unflag so you can reveal it.\n"
 				"You win if you identify every mine and reveal every other square.\n"
+				"Press S to save the game, and L to load the saved game back.\n"
+				"Press - and + to zoom out and in, and Spacebar or Enter to go back in to where the cursor is.\n"
+				"Press M to show or hide the map of the whole field, which appears when it doesn't fit on the screen.\n"
 				"Press Q to quit.\n";
 
 	/*Methods*/
@@ -96,18 +139,90 @@
 					if (isMine(*Minepoint))
 						fprintf(stderr, "*");
 					else
-						fprintf(stderr, "%d", Minepoint->value);
+						fprintf(stderr, "%d", getValue(*Minepoint));
 				}
 				fprintf(stderr, "\n");
 			}
 		}
 	#endif
 
+	#ifndef NO_MAIN // Left out when the front-end is linked into the benchmarks
 	int main(int argc, char *argv[]) {
-		int repeat;
+		int repeat, opt;
+		char* end;
+		uint64_t seed = 0;
+		int haveSeed = 0;
+		int noGuess = 0;
+		const char* replayPath = NULL;
+		int replayGame = 1;
+		long long replayMoves = -1;
+		long long number; // An option's value, before it is checked
 
 		settings Settings = DefaultSettings;
-		field Field = {NULL};
+		field Field = NULL;
+
+		if (FAILED(statsStart())) {
+			fprintf(stderr, "Could not set up %s\n", STATS_ENV);
+			exit(EXIT_FAILURE);
+		}
+
+		while ((opt = getopt(argc, argv, "s:f:j:r:g:m:F:n")) != -1) {
+			switch (opt) {
+				case 's': // Generate the (first) field from this seed, as printed at the end of a game
+					errno = 0;
+					seed = strtoull(optarg, &end, 0);
+					if (errno || !*optarg || *end) {
+						fprintf(stderr, "Invalid seed: %s\n", optarg);
+						exit(EXIT_FAILURE);
+					}
+					haveSeed = 1;
+					break;
+				case 'n': // Only generate fields that can be solved without guessing
+					noGuess = 1;
+					break;
+				case 'f': // Save and load games here
+					snapshotPath = optarg;
+					break;
+				case 'j': // Append every game and move to this journal
+					if (FAILED(openJournal(&gameJournal, optarg))) {
+						fprintf(stderr, "Could not open journal: %s\n", optarg);
+						exit(EXIT_FAILURE);
+					}
+					break;
+				case 'r': // Replay a game from this journal, instead of playing
+					replayPath = optarg;
+					break;
+				case 'g': // Which game in the journal to replay, from 1
+				case 'm': // How many of its moves to replay
+					errno = 0;
+					number = strtoll(optarg, &end, 0);
+					if (errno || !*optarg || *end || number < (opt == 'g')) {
+						fprintf(stderr, "Invalid %s: %s\n", (opt == 'g') ? "game" : "number of moves", optarg);
+						exit(EXIT_FAILURE);
+					}
+					if (opt == 'g') replayGame = (number > INT_MAX) ? INT_MAX : (int) number;
+					else replayMoves = number;
+					break;
+				case 'F': // Frame rate cap
+					errno = 0;
+					number = strtoll(optarg, &end, 0);
+					if (errno || !*optarg || *end || number < 0 || number > 1000000) {
+						fprintf(stderr, "Invalid frame rate: %s\n", optarg);
+						exit(EXIT_FAILURE);
+					}
+					frameRate = (int) number;
+					break;
+				default:
+					fprintf(stderr, "Usage: %s [-n] [-s seed] [-f snapshot] [-j journal] [-F fps]\n"
+					                "       %s -r journal [-g game] [-m moves]\n", argv[0], argv[0]);
+					exit(EXIT_FAILURE);
+			}
+		}
+
+		if (replayPath) {
+			err_file = stderr;
+			exit(FAILED(replay(replayPath, replayGame, replayMoves)) ? EXIT_FAILURE : EXIT_SUCCESS);
+		}
 
 		Settings.options = DEFAULT_NOT_TTY;
 		if (isatty(STDIN_FILENO) && isatty(STDOUT_FILENO)) {
@@ -119,18 +234,27 @@
 
 		err_file = HAS_OPTION(Settings, USE_STDERR) ? stderr : stdout;
 
+		if (noGuess) Settings.options |= NO_GUESS;
+		if (haveSeed) {
+			Settings.options |= FIXED_SEED;
+			Settings.seed = seed;
+		}
+		Engine = chooseEngine(Settings);
+		Renderer = chooseRenderer(Settings);
+
 		do {
 
 			if (FAILED(setup(&Field, &Settings))) {
 				if (Field) freeField(&Field);
-				fatal("Error while trying to set up game", EXIT_FAILURE);
+				protocolExit("Error while trying to set up game", EXIT_FAILURE);
 			}
+			Settings.options &= ~FIXED_SEED; // Playing again gets a new field
 
 			if (HAS_OPTION(Settings, SIMPLE_INPUT)) {
 				repeat = 0;
 				simplePlay(Field, Settings);
 			} else {
-				repeat = play(Field, Settings);
+				repeat = play(&Field, &Settings);
 				freeField(&Field);
 				if (repeat < 0) {
 					fatal("Error during play", EXIT_FAILURE);
@@ -139,8 +263,10 @@
 
 		} while (repeat);
 
+		closeJournal(&gameJournal);
 		exit(EXIT_SUCCESS);
 	}
+	#endif
 
 	int set_termios(void) {
 		struct termios Termios;
@@ -158,24 +284,23 @@
 		if (tcsetattr(STDIN_FILENO,TCSAFLUSH,&oldtermios) < 0) fatal("Failed to restore terminal", EXIT_FAILURE);
 	}
 
-	void fatal(const char* msg, int exitcode) {
-		fprintf(err_file, "%s\n", msg);
-		exit(exitcode);
-	}
-
 	int setup(field* Field, settings* Settings) {
 		if (FAILED(setSettings(Settings))) return EXIT_FAILURE;
 		if (FAILED(createField(Field, *Settings))) return EXIT_FAILURE;
 		if (HAS_OPTION(*Settings, GENERATE_MINES)) {
-			if (FAILED(buildField(*Field, *Settings, (int) time(NULL)))) return EXIT_FAILURE;
+			if (!HAS_OPTION(*Settings, FIXED_SEED)) Settings->seed = randomSeed();
+			if (FAILED(buildField(*Field, *Settings, Settings->seed))) return EXIT_FAILURE;
+			if (FAILED(journalGame(&gameJournal, *Settings))) return EXIT_FAILURE;
 		} else {
-			if (FAILED(promptMines(*Field, *Settings))) fatal("mine-error", EXIT_FAILURE);
+			if (FAILED(journalGame(&gameJournal, *Settings))) return EXIT_FAILURE;
+			if (FAILED(promptMines(*Field, *Settings))) protocolExit("mine-error", EXIT_FAILURE);
 		}
 		if (!HAS_OPTION(*Settings, SIMPLE_INPUT)) {
 			if (FAILED(set_termios())) {
 				fprintf(err_file, "Warning: Terminal did not set up properly\n");
 			}
 			if (atexit(unset_termios) != 0) return EXIT_FAILURE;
+			if (FAILED(watchScreenSize())) return EXIT_FAILURE;
 		}
 		return EXIT_SUCCESS;
 	}
@@ -185,36 +310,42 @@
 			const char* greeting = "Settings Selection: Please type in setting values or press Enter for defaults.\n"
 				                   "If you do not know what a setting does, the defaults are probably a good bet!\n";
 			fputs(greeting, stdout);
-			if (FAILED(askSetting(&(Settings->fieldSize.x), "Field Width", MinSize.x, MaxSize.x))) return EXIT_FAILURE;
-			if (FAILED(askSetting(&(Settings->fieldSize.y), "Field Height", MinSize.y, MaxSize.y))) return EXIT_FAILURE;
-			if (Settings->mines == -1) Settings->mines = defaultMineRatio * Settings->fieldSize.x * Settings->fieldSize.y; // set default based on size, if not set (-1 is "not set" flag value)
-			if (FAILED(askSetting(&(Settings->mines), "Number of Mines", MinMines, MIN(MaxMines, Settings->fieldSize.x * Settings->fieldSize.y - 1)))) return EXIT_FAILURE;
+			long long width = Settings->fieldSize.x, height = Settings->fieldSize.y, maxMines;
+			if (FAILED(askSetting(&width, "Field Width", MinSize.x, MaxSize.x))) return EXIT_FAILURE;
+			if (FAILED(askSetting(&height, "Field Height", MinSize.y, MaxSize.y))) return EXIT_FAILURE;
+			Settings->fieldSize.x = width;
+			Settings->fieldSize.y = height;
+			if (Settings->mines == -1) Settings->mines = defaultMineRatio * width * height; // set default based on size, if not set (-1 is "not set" flag value)
+			maxMines = MIN(MaxMines, width * height - 1);
+			if (FAILED(askSetting(&(Settings->mines), "Number of Mines", MinMines, maxMines))) return EXIT_FAILURE;
 		} else {
-			char s[STRING_LENGTH];
-			if (!fgets(s, STRING_LENGTH, stdin)) fatal("missing-input", EXIT_FAILURE);
+			const char* s;
+			size_t length;
+			char c;
+			if (!(s = inLine(&protocolIn, STDIN_FILENO, &length))) protocolExit("missing-input", EXIT_FAILURE);
 			if (s[0] != 'g') {
 				switch (s[0]) {
 					case 'g':
-						fatal("grid-error", EXIT_FAILURE);
+						protocolExit("grid-error", EXIT_FAILURE);
 					case 'u': case 'f':
-						fatal("unreveal-error", EXIT_FAILURE);
+						protocolExit("unreveal-error", EXIT_FAILURE);
 					default:
-						fatal("input-error", EXIT_FAILURE);
+						protocolExit("input-error", EXIT_FAILURE);
 				}
 			}
-			if (sscanf(s, "g %d %d\n", &Settings->fieldSize.x, &Settings->fieldSize.y) != 2) fatal("input-error", EXIT_FAILURE);
+			if (scanCommand(s, length, &c, &Settings->fieldSize) != 3) protocolExit("input-error", EXIT_FAILURE);
 			if (Settings->fieldSize.x <= 0 || Settings->fieldSize.x > 100 || Settings->fieldSize.y <= 0 || Settings->fieldSize.y > 100) {
-				fatal("grid-error", EXIT_FAILURE);
+				protocolExit("grid-error", EXIT_FAILURE);
 			}
-			printf("%c %d %d\n", 'g', Settings->fieldSize.x, Settings->fieldSize.y);
+			if (FAILED(outPrintf(&frameBuffer, "%c %d %d\n", 'g', Settings->fieldSize.x, Settings->fieldSize.y))) return EXIT_FAILURE;
 			Settings->mines = 10;
 		}
 		return EXIT_SUCCESS;
 	}
 
-	int askSetting(int* ptr, char* name, int min, int max) {
-		const char* fmt = "Please select a value for %s: (%d...%d) [%d]  > "; // SETTING NAME, MIN, MAX, DEFAULT
-		int value;
+	int askSetting(long long* ptr, char* name, long long min, long long max) {
+		const char* fmt = "Please select a value for %s: (%lld...%lld) [%lld]  > "; // SETTING NAME, MIN, MAX, DEFAULT
+		long long value;
 		char s[STRING_LENGTH];
 		int s_length;
 		int i;
@@ -236,12 +367,12 @@
 					good = 0;
 				}
 			}
-			if (!good || !sscanf(s, "%d", &value)) {
+			if (!good || !sscanf(s, "%lld", &value)) {
 				fprintf(stderr, "Invalid input. Please enter a number.\n");
 				continue;
 			}
 			if ((value < min) || (value > max)) {
-				fprintf(stderr, "Input outside range. Please provide a number between %d and %d.\n", min, max);
+				fprintf(stderr, "Input outside range. Please provide a number between %lld and %lld.\n", min, max);
 				continue;
 			}
 			*ptr = value;
@@ -251,169 +382,151 @@
 		return EXIT_SUCCESS;
 	}
 
-	int createField(field* Field, settings Settings) {
-		*Field = calloc(Settings.fieldSize.x * Settings.fieldSize.y, sizeof(minepoint));
-		if (!*Field) return EXIT_FAILURE;
-		return EXIT_SUCCESS;
-	}
-
-	int freeField(field* Field) {
-		free(*Field);
-		*Field = NULL;
-		return EXIT_SUCCESS;
-	}
-
-	int buildField(field Field, settings Settings, int seed) {
-		int i, r;
-		minepoint* mine;
-		minepoint* MinePoint;
-		point Point, countPoint;
-		srand(seed);
-
-		/* Assemble a list of available points for mines */
-		int length = 0;
-		point* potentials = malloc(Settings.fieldSize.x * Settings.fieldSize.y * sizeof(point));
-		for (Point.y=0; Point.y<Settings.fieldSize.y; Point.y++) for (Point.x=0; Point.x<Settings.fieldSize.x; Point.x++) {
-			potentials[length++] = Point;
-		}
-
-		for (i = 0; i < Settings.mines; i++) {
-			/* Some sanity checks */
-			if (!length) { // No room for more mines! (Settings limits should prevent this)
-				free(potentials);
-				return EXIT_FAILURE;
-			}
-
-			/* Get a point from available points - it's now a mine */
-			r = rand() % length;
-			Point = potentials[r];
-			mine = getMinepoint(Point, Field, Settings.fieldSize);
-			if (isMine(*mine)) {
-				free(potentials);
-				return EXIT_FAILURE; // sanity check
-			}
-			mine->value = -1;
-
-			/* Now we remove it from potentials, by replacing it with the last entry in the list and shortening it */
-			potentials[r] = potentials[--length];
-
-			/* Now increment all non-mines around it */
-			for (countPoint.y=Point.y-1;countPoint.y<=Point.y+1;countPoint.y++) {
-				for (countPoint.x=Point.x-1;countPoint.x<=Point.x+1;countPoint.x++) {
-					MinePoint = getMinepoint(countPoint, Field, Settings.fieldSize);
-					if (MinePoint && !isMine(*MinePoint)) MinePoint->value++; // This will also exclude Point when Point == countPoint
-				}
-			}
-		}
-
-		free(potentials);
-
-		return EXIT_SUCCESS;
-	}
-
 	int promptMines(field Field, settings Settings) {
 		int i;
-		point Point, countPoint;
+		point Point;
 		minepoint* mine;
-		minepoint* MinePoint;
-		char s[STRING_LENGTH];
+		const char* s;
+		size_t length;
+		char c;
 		for (i=0; i<10; i++) {
-			if (!fgets(s, STRING_LENGTH, stdin)) fatal("missing-input", EXIT_FAILURE);
+			if (!(s = inLine(&protocolIn, STDIN_FILENO, &length))) protocolExit("missing-input", EXIT_FAILURE);
 			if (s[0] != 'b') {
 				switch (s[0]) {
 					case 'g':
-						fatal("grid-error", EXIT_FAILURE);
+						protocolExit("grid-error", EXIT_FAILURE);
 					case 'u': case 'f':
-						fatal("unreveal-error", EXIT_FAILURE);
+						protocolExit("unreveal-error", EXIT_FAILURE);
 					default:
-						fatal("input-error", EXIT_FAILURE);
+						protocolExit("input-error", EXIT_FAILURE);
 				}
 			}
-			if (sscanf(s, "b %d %d\n", &Point.x, &Point.y) != 2) fatal("input-error", EXIT_FAILURE);
+			if (scanCommand(s, length, &c, &Point) != 3) protocolExit("input-error", EXIT_FAILURE);
 			if (!(mine = getMinepoint(Point, Field, Settings.fieldSize))) return EXIT_FAILURE;
 			if (isMine(*mine)) return EXIT_FAILURE;
-			mine->value = -1;
-			printf("%c %d %d\n", 'b', Point.x, Point.y);
-
-			/* Now increment all non-mines around it */
-			for (countPoint.y=Point.y-1;countPoint.y<=Point.y+1;countPoint.y++) {
-				for (countPoint.x=Point.x-1;countPoint.x<=Point.x+1;countPoint.x++) {
-					MinePoint = getMinepoint(countPoint, Field, Settings.fieldSize);
-					if (MinePoint && !isMine(*MinePoint)) MinePoint->value++; // This will also exclude Point when Point == countPoint
-				}
-			}
-
+			setValue(mine, -1);
+			if (FAILED(journalMove(&gameJournal, JOURNAL_MINE, Point))) return EXIT_FAILURE;
+			if (FAILED(outPrintf(&frameBuffer, "%c %d %d\n", 'b', Point.x, Point.y))) return EXIT_FAILURE;
 		}
+		recountField(Field); // Set every value from the mines in one pass
 		return EXIT_SUCCESS;
 	}
 
-	minepoint* getMinepoint(point Point, field Field, point FieldSize) {
-		if (Point.x < 0 || Point.x >= FieldSize.x || Point.y < 0 || Point.y >= FieldSize.y)
-			return NULL; // Out of Bounds
-		return &Field[point2offset(Point, FieldSize.x)];
-	}
-
-	int point2offset(point Point, int xsize) {
-		return Point.y * xsize + Point.x;
-	}
-
-	int isMine(minepoint MinePoint) {return MinePoint.value == -1;}
-
-	int play(field Field, settings Settings) {
+	int play(field* Field, settings* Settings) {
 		int quit = 0;
-		int c, i;
+		int c, i, result;
 		char s[STRING_LENGTH];
-		point Cursor = {Settings.fieldSize.x/2, Settings.fieldSize.y/2};
+		point Cursor = {Settings->fieldSize.x/2, Settings->fieldSize.y/2};
+		field NewField;
+		settings NewSettings;
+		int journalling = 1; // Whether moves still go in the journal
+		long long frameTime;
+
+		resetDisplay(); // Whatever is on screen now (setup prompts, the last game) isn't ours
+		keyIn.start = keyIn.length = 0; // Anything left from the last game was typed after it ended
+		zoom = 0;
+		summariseField(*Field); // Without it there is just no zooming out
 
 		while (!quit) {
 			// Always display first - Displays before first turn and also lets input code quit without display being called first.
-			if (FAILED(display(Field, Settings, Cursor))) return EXIT_FAILURE;
-
-			c = fgetc(stdin);
-
-			/* Handle Inputs */
-			switch (c) {
-				case CSI_CHARS(0): // Begins control sequence - check if its an UP, DOWN, LEFT or RIGHT
-					i = 0;
-					s[i++] = c; // ESC
-					s[i++] = (c = fgetc(stdin)); // 2nd byte
-					if (c == CSI_CHARS(1)) { // if CSI
-						while (c = fgetc(stdin), c != EOF && i < STRING_LENGTH-2 && (c < 0x40 || c > 0x7e)) s[i++] = c; // loop until valid final byte is found
-					}
-					if (c != EOF) s[i++] = c; // Add final char
-					s[i++] = '\0';
-					if (strcmp(s, CURSOR_UP) == 0 && Cursor.y > 0) Cursor.y--;
-					if (strcmp(s, CURSOR_DOWN) == 0 && Cursor.y < Settings.fieldSize.y-1) Cursor.y++;
-					if (strcmp(s, CURSOR_LEFT) == 0 && Cursor.x > 0) Cursor.x--;
-					if (strcmp(s, CURSOR_RIGHT) == 0 && Cursor.x < Settings.fieldSize.x-1) Cursor.x++;
-					break;
-				case 'f': // Flag space
-					setPointTo(Field, Settings, Cursor, FLAGGED);
-					break;
-				case '\n': case ' ': // Reveal space
-					if (setPointTo(Field, Settings, Cursor, DISPLAYED) == -1) {
-						/* Dead! */
-						quit = 1;
-						if (FAILED(lose(Field, Settings, Cursor))) return EXIT_FAILURE;
-					}
-					break;
-				case '?': case 'h': // Print help
-					printf(CLEAR
-					       "%s" // helpString
-					       "Press any key to continue...\n"
-					, helpString);
-					fgetc(stdin); // block until keypress
-					break;
-				case 'q': case EOF: // Quit
-					return 0;
-				default: // ignore
-					break;
-			}
+			if (FAILED(display(*Field, *Settings, Cursor))) return EXIT_FAILURE;
+			frameTime = statsNow();
+
+			/* Take every key typed until the next frame is due, and draw once for all of them,
+			   so a held key moves the cursor as far as it should without a backlog of frames */
+			if (FAILED(readKeys(&keyIn, STDIN_FILENO, frameRate ? frameTime + 1000000000LL / frameRate : 0))) return -1;
+			if (keyIn.start == keyIn.length && !keyIn.eof) continue; // Woken by a resize, so just redraw
+
+			do {
+				c = keyByte(&keyIn, STDIN_FILENO);
+
+				/* Handle Inputs */
+				switch (c) {
+					case CSI_CHARS(0): // Begins control sequence - check if its an UP, DOWN, LEFT or RIGHT
+						i = 0;
+						s[i++] = c; // ESC
+						s[i++] = (c = keyByte(&keyIn, STDIN_FILENO)); // 2nd byte
+						if (c == CSI_CHARS(1)) { // if CSI
+							while (c = keyByte(&keyIn, STDIN_FILENO), c != EOF && i < STRING_LENGTH-2 && (c < 0x40 || c > 0x7e)) s[i++] = c; // loop until valid final byte is found
+						}
+						if (c != EOF) s[i++] = c; // Add final char
+						s[i++] = '\0';
+						/* Zoomed out, the cursor moves a block at a time */
+						if (strcmp(s, CURSOR_UP) == 0) Cursor.y = (Cursor.y > (1 << zoom)) ? Cursor.y - (1 << zoom) : 0;
+						if (strcmp(s, CURSOR_DOWN) == 0) Cursor.y = (Settings->fieldSize.y-1 - Cursor.y > (1 << zoom)) ? Cursor.y + (1 << zoom) : Settings->fieldSize.y-1;
+						if (strcmp(s, CURSOR_LEFT) == 0) Cursor.x = (Cursor.x > (1 << zoom)) ? Cursor.x - (1 << zoom) : 0;
+						if (strcmp(s, CURSOR_RIGHT) == 0) Cursor.x = (Settings->fieldSize.x-1 - Cursor.x > (1 << zoom)) ? Cursor.x + (1 << zoom) : Settings->fieldSize.x-1;
+						break;
+					case '-': // Zoom out, until the whole field is one block
+						if (!(*Field)->Summary || zoom >= (*Field)->Summary->top) fputs(BELL, stdout);
+						else zoom++;
+						break;
+					case '+': case '=': // Zoom in
+						if (zoom) zoom--;
+						break;
+					case 'm': case 'M': // Show or hide the minimap
+						minimap = !minimap;
+						break;
+					case 'f': // Flag space
+						if (zoom) break; // No telling which square is meant
+						if ((result = Engine->setPointTo(*Field, *Settings, Cursor, FLAGGED)) < ENGINE_MINE) fatal(engineError(result), EXIT_FAILURE);
+						if (journalling && FAILED(journalMove(&gameJournal, JOURNAL_FLAG, Cursor))) return -1;
+						break;
+					case '\n': case ' ': // Reveal space
+						if (zoom) { // Or go back to seeing squares, around the cursor
+							zoom = 0;
+							break;
+						}
+						if ((result = Engine->setPointTo(*Field, *Settings, Cursor, DISPLAYED)) < ENGINE_MINE) fatal(engineError(result), EXIT_FAILURE);
+						if (journalling && FAILED(journalMove(&gameJournal, JOURNAL_REVEAL, Cursor))) return -1;
+						if (result == ENGINE_MINE) {
+							/* Dead! */
+							quit = 1;
+							if (FAILED(lose(*Field, *Settings, Cursor))) return EXIT_FAILURE;
+						}
+						break;
+					case '?': case 'h': // Print help
+						printf(CLEAR
+						       "%s" // helpString
+						       "Press any key to continue...\n"
+						, helpString);
+						keyByte(&keyIn, STDIN_FILENO); // block until keypress
+						resetDisplay();
+						break;
+					case 's': // Save the game to snapshotPath
+						if (FAILED(saveField(*Field, *Settings, snapshotPath))) fputs(BELL, stdout);
+						break;
+					case 'l': // Load the game from snapshotPath, keeping our own display options
+						if (FAILED(loadField(&NewField, &NewSettings, snapshotPath))) {
+							fputs(BELL, stdout);
+							break;
+						}
+						freeField(Field);
+						*Field = NewField;
+						journalling = 0; // The journal can't say how we got here, so the rest of this game isn't in it
+						NewSettings.options = (NewSettings.options & GAME_OPTIONS) | (Settings->options & ~GAME_OPTIONS);
+						*Settings = NewSettings;
+						Engine = chooseEngine(*Settings); // Its rules may not be ours
+						Cursor.x = Settings->fieldSize.x/2;
+						Cursor.y = Settings->fieldSize.y/2;
+						zoom = 0;
+						summariseField(*Field);
+						resetDisplay();
+						break;
+					case 'q': case EOF: // Quit
+						return 0;
+					default: // ignore
+						break;
+				}
 
-			if (!quit && checkWin(Field, Settings)) { // don't check win if we are quitting - what if we just lost?
-				quit = 1;
-				if (FAILED(win(Field, Settings, Cursor))) return EXIT_FAILURE;
-			}
+				if (!quit && (result = Engine->checkWin(*Field, *Settings))) { // don't check win if we are quitting - what if we just lost?
+					if (result < 0) fatal(engineError(result), EXIT_FAILURE);
+					quit = 1;
+					if (FAILED(win(*Field, *Settings, Cursor))) return EXIT_FAILURE;
+				}
+			} while (!quit && keyIn.start < keyIn.length); // The rest of the batch, unless the game is over
+
+			if (FAILED(flushJournal(&gameJournal))) return -1;
 		}
 
 		unset_termios();
@@ -428,198 +541,296 @@
 	}
 
 	void simplePlay(field Field, settings Settings) {
-		char s[STRING_LENGTH];
+		const char* s;
+		size_t length;
 		char c;
 		point Point = {0,0};
 		enum display Display;
+		int result;
 
 		while(1) {
-			display(Field, Settings, Point);
+			if (FAILED(display(Field, Settings, Point))) protocolExit("Out of memory", EXIT_FAILURE);
 
-			if (!fgets(s, STRING_LENGTH, stdin)) fatal("missing-input", EXIT_FAILURE);
-			if (sscanf(s, "%c %d %d", &c, &Point.x, &Point.y) != 3) fatal("input-error", EXIT_FAILURE);
-			if (!getMinepoint(Point, Field, Settings.fieldSize)) fatal("uncover-error", EXIT_FAILURE);
+			if (!(s = inLine(&protocolIn, STDIN_FILENO, &length))) protocolExit("missing-input", EXIT_FAILURE);
+			if (scanCommand(s, length, &c, &Point) != 3) protocolExit("input-error", EXIT_FAILURE);
+			if (!getMinepoint(Point, Field, Settings.fieldSize)) protocolExit("uncover-error", EXIT_FAILURE);
 			Display = (enum display) (c == 'u') ? DISPLAYED : (c == 'f') ? FLAGGED : (0);
 			if (!Display) {
 				switch (s[0]) {
 					case 'g':
-						fatal("grid-error", EXIT_FAILURE);
+						protocolExit("grid-error", EXIT_FAILURE);
 					case 'u': case 'f':
-						fatal("unreveal-error", EXIT_FAILURE);
+						protocolExit("unreveal-error", EXIT_FAILURE);
 					default:
-						fatal("input-error", EXIT_FAILURE);
+						protocolExit("input-error", EXIT_FAILURE);
 				}
 			}
-			if (setPointTo(Field, Settings, Point, Display) == -1 && Display == DISPLAYED) {
-				fputs(s, stdout);
-				fatal("lost",EXIT_SUCCESS);
+			if ((result = Engine->setPointTo(Field, Settings, Point, Display)) < ENGINE_MINE) protocolExit(engineError(result), EXIT_FAILURE);
+			if (FAILED(journalMove(&gameJournal, (Display == FLAGGED) ? JOURNAL_FLAG : JOURNAL_REVEAL, Point))) {
+				protocolExit("Could not write journal", EXIT_FAILURE);
+			}
+			if (result == ENGINE_MINE && Display == DISPLAYED) {
+				outAppend(&frameBuffer, s, strnlen(s, length)); // The move that lost, as it was given
+				protocolExit("lost",EXIT_SUCCESS);
 			}
 
-			printf("%c %d %d\n", c, Point.x, Point.y);
+			if (FAILED(outPrintf(&frameBuffer, "%c %d %d\n", c, Point.x, Point.y))) protocolExit("Out of memory", EXIT_FAILURE);
 
-			if (checkWin(Field, Settings)) {
+			if ((result = Engine->checkWin(Field, Settings))) {
+				if (result < 0) protocolExit(engineError(result), EXIT_FAILURE);
 				display(Field, Settings, Point);
-				fatal("won", EXIT_SUCCESS);
+				protocolExit("won", EXIT_SUCCESS);
 			}
 		}	
 	}
 
-	int setPointTo(field Field, settings Settings, point Point, enum display Display) {
-		minepoint* MinePoint = getMinepoint(Point, Field, Settings.fieldSize);
-		if (!MinePoint) {
-			fatal("Tried to access minepoint outside field!", EXIT_FAILURE);
-		}
-		switch (Display) {
-			case FLAGGED: // On flagged, toggle/error flag or ignore/error if displayed
-				switch (MinePoint->Display) {
-					case HIDDEN:
-						if (HAS_OPTION(Settings, STRICT_WIN_CHECKS)) {
-							int i, count = 0;
-							for (i=0; i<Settings.fieldSize.x*Settings.fieldSize.y; i++) {
-								if (Field[i].Display == FLAGGED) count++;
-							}
-							if (count >= Settings.mines && HAS_OPTION(Settings, FRAGILE)) fatal("uncover-error", EXIT_FAILURE);
-						}
-						MinePoint->Display = FLAGGED;
-						break;
-					case FLAGGED:
-						if (HAS_OPTION(Settings, FRAGILE)) fatal("uncover-error", EXIT_FAILURE);
-						MinePoint->Display = HIDDEN;
-						break;
-					default:
-						break;
-				}
-				break;
-			case DISPLAYED: // On displayed, reveal and possibly expand zeroes.
-				if (MinePoint->Display != DISPLAYED) {
-					MinePoint->Display = DISPLAYED;
-					if (MinePoint->value == 0 && HAS_OPTION(Settings, EXPAND_ZEROES)) {
-						point nextPoint;
-						for (nextPoint.x=Point.x-1; nextPoint.x<=Point.x+1; nextPoint.x++)
-						for (nextPoint.y=Point.y-1; nextPoint.y<=Point.y+1; nextPoint.y++) {
-							if (nextPoint.x >= 0 && nextPoint.x < Settings.fieldSize.x &&
-							    nextPoint.y >= 0 && nextPoint.y < Settings.fieldSize.y &&
-							    setPointTo(Field, Settings, nextPoint, DISPLAYED) == -1) {
-								// Got a mine during expansion, this shouldn't happen!
-								fatal("Found a mine during Zero Expansion, error in field!", EXIT_FAILURE);
-							}
-						}
-					}
-				} else if (HAS_OPTION(Settings, FRAGILE)) fatal("uncover-error", EXIT_FAILURE);
-				break;
-			default:
-				break;
-		}
-		return MinePoint->value;
-	}
-
-	int checkWin(field Field, settings Settings) {
-		int i;
-		if (HAS_OPTION(Settings, STRICT_WIN_CHECKS)) {
-			for (i=0; i<Settings.fieldSize.x*Settings.fieldSize.y; i++) {
-				if (Field[i].Display == HIDDEN) return 0;
-			}
-			return 1;
-		} else {
-			// Win conditions: the count of HIDDEN or FLAGGED squares is equal to the number of mines
-			int count = 0;
-			for (i=0; i<Settings.fieldSize.x*Settings.fieldSize.y; i++) {
-				if (Field[i].Display != DISPLAYED) count++;
-			}
-			if (count < Settings.mines) { // sanity check
-				fatal("Too many squares revealed - some MUST be mines!", EXIT_FAILURE);
-			}
-			return (count == Settings.mines);
-		}
-	}
-
 	int win(field Field, settings Settings, point Cursor) {
-		int i;
-		for (i=0; i < Settings.fieldSize.x * Settings.fieldSize.y; i++) {
-			if (isMine(Field[i])) Field[i].Display = FLAGGED;
-		}
+		endField(Field, FLAGGED);
 		display(Field, Settings, Cursor);
+		if (!HAS_OPTION(Settings, SIMPLE_OUTPUT)) printf(SET_CURSOR_FMT, screenBufferSize.y, 1); // Message goes below the field
 		printf("\nCongratulations! You won!\n");
+		if (HAS_OPTION(Settings, GENERATE_MINES)) printf("Field seed: 0x%016" PRIx64 "\n", Settings.seed);
 		return EXIT_SUCCESS;
 	}
 
 	int lose(field Field, settings Settings, point Cursor) {
-		int i;
-		for (i=0; i < Settings.fieldSize.x * Settings.fieldSize.y; i++) {
-			if (isMine(Field[i]) && Field[i].Display == HIDDEN) Field[i].Display = DISPLAYED;
-		}
+		endField(Field, DISPLAYED);
 		display(Field, Settings, Cursor);
+		if (!HAS_OPTION(Settings, SIMPLE_OUTPUT)) printf(SET_CURSOR_FMT, screenBufferSize.y, 1); // Message goes below the field
 		printf("\nYou lose!\n");
+		if (HAS_OPTION(Settings, GENERATE_MINES)) printf("Field seed: 0x%016" PRIx64 "\n", Settings.seed);
 		return EXIT_SUCCESS;
 	}
 
 	int display(field Field, settings Settings, point Cursor) {
-		point screenSize, TopLeft, Point;
-		minepoint* Minepoint;
-		const char** displayString; //ptr to string literal array, defined above
-		int simple = HAS_OPTION(Settings, SIMPLE_OUTPUT);
-
-		if (simple) {
-			// If border, a little out of bounds.
-			int border = !!HAS_OPTION(Settings, BORDER);
-			screenSize.x = Settings.fieldSize.x + 2*border;
-			screenSize.y = Settings.fieldSize.y + 2*border;
-			TopLeft.x = -border;
-			TopLeft.y = -border;
-		} else {
-			screenSize = getScreenSize();
-			if (screenSize.x < 0 && screenSize.y < 0) return EXIT_FAILURE;
-			TopLeft.x = Cursor.x - screenSize.x/2;
-			TopLeft.y = Cursor.y - screenSize.y/2;
+		long long bytes = Stats.bytes + frameBuffer.length; // Written, or waiting to be, before this frame
+		int result;
+		STAT_START(start);
+
+		result = Renderer(Field, Settings, Cursor);
+
+		if (STATS_ON) {
+			Stats.frames++;
+			statsRecord(&Stats.FrameBytes, Stats.bytes + frameBuffer.length - bytes);
+			STAT_TIME(DisplayTime, start);
+			if (Stats.keyStart && !HAS_OPTION(Settings, SIMPLE_INPUT)) { // Otherwise it's only written out later
+				STAT_TIME(KeyLatency, Stats.keyStart);
+				Stats.keyStart = 0;
+			}
 		}
+		return result;
+	}
+
+	int drawFrame(field Field, settings Settings, point Cursor) {
+		if (HAS_OPTION(Settings, SIMPLE_OUTPUT)) return simple_display(Field, Settings);
+		return new_display(Field, Settings, Cursor);
+	}
+
+	int drawInteractive(field Field, settings Settings, point Cursor) {
+		return newDisplayAs(Field, &Settings, Cursor, (DEFAULT_INTERACTIVE) & RENDER_OPTIONS);
+	}
+
+	int drawNotTty(field Field, settings Settings, point Cursor) {
+		(void) Cursor;
+		return simpleDisplayAs(Field, &Settings, (DEFAULT_NOT_TTY) & RENDER_OPTIONS);
+	}
+
+	renderer chooseRenderer(settings Settings) {
+		switch (Settings.options & RENDER_OPTIONS) {
+			case (DEFAULT_INTERACTIVE) & RENDER_OPTIONS: return drawInteractive;
+			case (DEFAULT_NOT_TTY) & RENDER_OPTIONS: return drawNotTty;
+			default: return drawFrame;
+		}
+	}
+
+	int simple_display(field Field, settings Settings) {
+		return simpleDisplayAs(Field, &Settings, Settings.options);
+	}
+
+	SPECIALISED int simpleDisplayAs(field Field, const settings* Settings, unsigned int options) {
+		point screenSize, TopLeft, Point;
+		char row[STRING_LENGTH + 1]; // Cells are gathered here, so frameBuffer grows a row at a time
+		int length = 0;
+		point Position;
+		tile* Tile;
+		minepoint* points; // The current tile's row, or NULL to look it up
+
+		// If border, a little out of bounds.
+		int border = !!(options & BORDER);
+		screenSize.x = Settings->fieldSize.x + 2*border;
+		screenSize.y = Settings->fieldSize.y + 2*border;
+		TopLeft.x = -border;
+		TopLeft.y = -border;
 
-		if (!simple) printf(CLEAR);
 		for (Point.y=TopLeft.y; Point.y<TopLeft.y+screenSize.y; Point.y++) {
+			points = NULL;
 			for (Point.x=TopLeft.x; Point.x<TopLeft.x+screenSize.x; Point.x++) {
-				Minepoint = getMinepoint(Point, Field, Settings.fieldSize);
-				if (Minepoint) {
-					if (!simple && Point.x == Cursor.x && Point.y == Cursor.y) fputs(INVERTCOLOURS, stdout);
-					displayString = getStr(*Minepoint);
-				} else {
-					// Point out of range
-					displayString = displayString_OffField;
-					if (HAS_OPTION(Settings, BORDER) &&
-					    Point.x >= -1 && Point.x <= Settings.fieldSize.x &&
-					    Point.y >= -1 && Point.y <= Settings.fieldSize.y)
-					{
-						int i = (Point.x == -1) + (Point.x == Settings.fieldSize.x) +
-						        2 * ((Point.y == -1) + (Point.y == Settings.fieldSize.y));
-						if (i) displayString = displayString_Border[i-1];
+				if (Point.x >= 0 && Point.x < Settings->fieldSize.x && Point.y >= 0 && Point.y < Settings->fieldSize.y) {
+					/* Walk along the tile's row directly, rather than looking up every square */
+					if (!points || !(Point.x & TILE_MASK)) {
+						Position.x = Point.x >> TILE_SHIFT;
+						Position.y = Point.y >> TILE_SHIFT;
+						if (!(Tile = getTile(Field, Position, 1))) return EXIT_FAILURE;
+						points = &Tile->points[(Point.y & TILE_MASK) << TILE_SHIFT];
 					}
+					row[length++] = getStr(points[Point.x & TILE_MASK])[1][0]; // Every display string is one character
+				} else {
+					row[length++] = borderStrAs(Point, Settings->fieldSize, options)[1][0];
+				}
+				if (length == STRING_LENGTH) {
+					if (FAILED(outAppend(&frameBuffer, row, length))) return EXIT_FAILURE;
+					length = 0;
 				}
-				if (!simple) fputs(displayString[0], stdout);
-				fputs(displayString[1], stdout);
-				if (!simple) fputs(UNFORMAT, stdout);
 			}
-			printf("\n");
+			row[length++] = '\n';
+			if (FAILED(outAppend(&frameBuffer, row, length))) return EXIT_FAILURE;
+			length = 0;
 		}
-		return EXIT_SUCCESS;
+		if (options & SIMPLE_INPUT) return EXIT_SUCCESS; // Written out once per block of input, by inLine()
+		return outFlush(&frameBuffer, STDOUT_FILENO);
 	}
 
 	int new_display(field Field, settings Settings, point Cursor) {
-		static char* screenBuffer = NULL;
-		static point screenSize = {-1, -1};
-		/*
-			Each time, write to newScreenBuffer.
-			Compare to screenBuffer (how? because escapes don't work that way).
-				Option: ScreenBuffer is made of displayStrings (ie. const char*[2])
-			Only print changes, using set cursor.
-		*/
+		return newDisplayAs(Field, &Settings, Cursor, Settings.options);
+	}
+
+	SPECIALISED int newDisplayAs(field Field, const settings* Settings, point Cursor, unsigned int options) {
+		point screenSize, Point, screenPoint, MapSize = {0, 0}, MapTopLeft = {0, 0};
+		point termCursor = {-1, -1}; // Where the terminal's cursor is (as a screen position), if known
+		const char** displayString; //ptr to string literal array, defined above
+		screencell* Cell;
+		int inverted, border = !!(options & BORDER), mapLevel = -1;
+
+		screenSize = getScreenSize();
+		if (screenSize.x < 0 && screenSize.y < 0) return EXIT_FAILURE;
+
+		if (!screenBuffer || screenSize.x != screenBufferSize.x || screenSize.y != screenBufferSize.y) {
+			/* New or resized screen - start again from a blank terminal, centred on the cursor */
+			free(screenBuffer);
+			screenBuffer = malloc(screenSize.x * screenSize.y * sizeof(screencell));
+			if (!screenBuffer) return EXIT_FAILURE;
+			screenBufferSize = screenSize;
+			screenZoom = -1; // Centre on the cursor, below
+			if (FAILED(outPuts(&frameBuffer, CLEAR))) return EXIT_FAILURE;
+			for (Cell = screenBuffer; Cell < screenBuffer + screenSize.x * screenSize.y; Cell++) {
+				Cell->displayString = displayString_OffField; // A cleared terminal is all blanks
+				Cell->inverted = 0;
+			}
+		}
+
+		/* Zoomed out, everything is in blocks: the cursor is the block it's in */
+		if (Field->Summary && Field->Summary->failed) summariseField(Field); // Some changes went uncounted, for want of memory
+		if (!Field->Summary) zoom = 0;
+		Cursor.x >>= zoom;
+		Cursor.y >>= zoom;
+		if (screenZoom != zoom) {
+			screenTopLeft.x = Cursor.x - screenSize.x/2;
+			screenTopLeft.y = Cursor.y - screenSize.y/2;
+			screenZoom = zoom;
+		}
+
+		/* Only scroll when the cursor leaves the screen, so moving it normally redraws just two cells */
+		if (Cursor.x < screenTopLeft.x || Cursor.x >= screenTopLeft.x + screenSize.x) screenTopLeft.x = Cursor.x - screenSize.x/2;
+		if (Cursor.y < screenTopLeft.y || Cursor.y >= screenTopLeft.y + screenSize.y) screenTopLeft.y = Cursor.y - screenSize.y/2;
+
+		/* A minimap of the whole field goes in the top right corner, if the field doesn't fit and the map will */
+		if (!zoom && minimap && Field->Summary &&
+		    (Settings->fieldSize.x + 2*border > screenSize.x || Settings->fieldSize.y + 2*border > screenSize.y)) {
+			for (mapLevel = 1; ((Settings->fieldSize.x - 1) >> mapLevel) >= MINIMAP_WIDTH || ((Settings->fieldSize.y - 1) >> mapLevel) >= MINIMAP_HEIGHT; mapLevel++);
+			MapSize.x = ((Settings->fieldSize.x - 1) >> mapLevel) + 1;
+			MapSize.y = ((Settings->fieldSize.y - 1) >> mapLevel) + 1;
+			MapTopLeft.x = screenSize.x - MapSize.x;
+			MapTopLeft.y = 0;
+			if (MapSize.x * 2 > screenSize.x || MapSize.y * 2 > screenSize.y) mapLevel = -1; // It would be in the way
+		}
+
+		for (screenPoint.y=0; screenPoint.y<screenSize.y; screenPoint.y++) {
+			for (screenPoint.x=0; screenPoint.x<screenSize.x; screenPoint.x++) {
+				Point.x = screenTopLeft.x + screenPoint.x;
+				Point.y = screenTopLeft.y + screenPoint.y;
+				if (mapLevel >= 0 && screenPoint.x >= MapTopLeft.x && screenPoint.y < MapTopLeft.y + MapSize.y) {
+					/* Part of the minimap, inverted where the screen shows */
+					Point.x = screenPoint.x - MapTopLeft.x;
+					Point.y = screenPoint.y - MapTopLeft.y;
+					displayString = getBlockStr(Field, *Settings, mapLevel, Point);
+					inverted = ((long long) (Point.x + 1) << mapLevel) > screenTopLeft.x && ((long long) Point.x << mapLevel) < screenTopLeft.x + screenSize.x &&
+					           ((long long) (Point.y + 1) << mapLevel) > screenTopLeft.y && ((long long) Point.y << mapLevel) < screenTopLeft.y + screenSize.y;
+				} else {
+					displayString = zoom ? getBlockStr(Field, *Settings, zoom, Point) : screenStrAs(Field, Settings, Point, options);
+					inverted = (Point.x == Cursor.x && Point.y == Cursor.y);
+				}
+
+				Cell = &screenBuffer[point2offset(screenPoint, screenSize.x)];
+				if (Cell->displayString == displayString && Cell->inverted == inverted) continue; // Unchanged
+				Cell->displayString = displayString;
+				Cell->inverted = inverted;
+
+				if (termCursor.x != screenPoint.x || termCursor.y != screenPoint.y) {
+					if (FAILED(outPrintf(&frameBuffer, SET_CURSOR_FMT, screenPoint.y + 1, screenPoint.x + 1))) return EXIT_FAILURE;
+				}
+				if (FAILED(outFormat(&frameBuffer, (options & FORMATTING) ? displayString[0] : NULL, inverted))) return EXIT_FAILURE;
+				if (FAILED(outPuts(&frameBuffer, displayString[1]))) return EXIT_FAILURE;
+				termCursor.x = screenPoint.x + 1; // Unknown (pending wrap) after the last column, which never matches
+				termCursor.y = screenPoint.y;
+			}
+		}
+		if (FAILED(outFormat(&frameBuffer, NULL, 0))) return EXIT_FAILURE; // Leave the terminal unformatted for anyone else
+		return outFlush(&frameBuffer, STDOUT_FILENO);
+	}
+
+	void resetDisplay(void) {
+		free(screenBuffer);
+		screenBuffer = NULL;
+	}
+
+	const char** getScreenStr(field Field, settings Settings, point Point) {
+		return screenStrAs(Field, &Settings, Point, Settings.options);
+	}
+
+	SPECIALISED const char** screenStrAs(field Field, const settings* Settings, point Point, unsigned int options) {
+		minepoint* Minepoint = getMinepoint(Point, Field, Settings->fieldSize);
+		if (Minepoint) return getStr(*Minepoint);
+		return borderStrAs(Point, Settings->fieldSize, options); // Point out of range
+	}
+
+	const char** getBlockStr(field Field, settings Settings, int level, point Block) {
+		point Blocks = {((Settings.fieldSize.x - 1) >> level) + 1, ((Settings.fieldSize.y - 1) >> level) + 1};
+		long long shown, flagged, width, height;
+
+		if (Block.x < 0 || Block.x >= Blocks.x || Block.y < 0 || Block.y >= Blocks.y) return getBorderStr(Settings, Block, Blocks);
+		summaryCounts(Field, level, Block, &shown, &flagged);
+		if (!shown && !flagged) return displayString_Block[0];
+
+		/* Blocks on the right and bottom edges may be cut short by the edge of the field */
+		width = MIN((long long) (Block.x + 1) << level, Settings.fieldSize.x) - ((long long) Block.x << level);
+		height = MIN((long long) (Block.y + 1) << level, Settings.fieldSize.y) - ((long long) Block.y << level);
+		return (shown + flagged < width * height) ? displayString_Block[1] : displayString_Block[2];
+	}
+
+	const char** getBorderStr(settings Settings, point Point, point Size) {
+		return borderStrAs(Point, Size, Settings.options);
+	}
+
+	SPECIALISED const char** borderStrAs(point Point, point Size, unsigned int options) {
+		if ((options & BORDER) &&
+		    Point.x >= -1 && Point.x <= Size.x &&
+		    Point.y >= -1 && Point.y <= Size.y)
+		{
+			int i = (Point.x == -1) + (Point.x == Size.x) +
+			        2 * ((Point.y == -1) + (Point.y == Size.y));
+			if (i) return displayString_Border[i-1];
+		}
+		return displayString_OffField;
 	}
 
 	const char** getStr(minepoint MinePoint) {
-		switch (MinePoint.Display) {
+		switch (getDisplay(MinePoint)) {
 			case HIDDEN:
 				return displayString_Hidden;
 			case FLAGGED:
 				return displayString_Flag;
 			case DISPLAYED:
-				return (isMine(MinePoint)) ? displayString_Mine : displayString_Values[MinePoint.value];
+				return (isMine(MinePoint)) ? displayString_Mine : displayString_Values[getValue(MinePoint)];
 			default:
 				fatal("Corrupt minepoint object - illegal Display value", EXIT_FAILURE);
 		}
@@ -628,10 +839,234 @@
 
 	point getScreenSize(void) {
 		struct winsize w;
-		point Point = {-1, -1};
-		if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &w) >= 0) { // if ioctl fails, will return Point with default (error) values
-			Point.y = w.ws_row;
-			Point.x = w.ws_col;
+		if (screenResized) {
+			screenResized = 0; // First, so a resize while we ask isn't lost
+			terminalSize.x = terminalSize.y = -1; // if ioctl fails, will return default (error) values
+			if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &w) >= 0) {
+				terminalSize.y = w.ws_row;
+				terminalSize.x = w.ws_col;
+			}
 		}
-		return Point;
+		return terminalSize;
+	}
+
+	int watchScreenSize(void) {
+		struct sigaction Action;
+		memset(&Action, 0, sizeof(Action));
+		Action.sa_handler = onResize;
+		Action.sa_flags = SA_RESTART; // Only poll() in readKeys() should notice
+		sigemptyset(&Action.sa_mask);
+		if (sigaction(SIGWINCH, &Action, NULL) < 0) return EXIT_FAILURE;
+		screenResized = 1; // It may have changed before now
+		return EXIT_SUCCESS;
+	}
+
+	void onResize(int signal) {
+		(void) signal;
+		screenResized = 1;
+	}
+
+	int outAppend(outbuffer* Out, const char* str, size_t length) {
+		if (Out->length + length > Out->size) {
+			size_t size = Out->size ? Out->size : 4096;
+			char* data;
+			while (size < Out->length + length) size *= 2;
+			if (!(data = realloc(Out->data, size))) return EXIT_FAILURE;
+			Out->data = data;
+			Out->size = size;
+		}
+		memcpy(Out->data + Out->length, str, length);
+		Out->length += length;
+		return EXIT_SUCCESS;
+	}
+
+	int outPuts(outbuffer* Out, const char* str) {
+		return outAppend(Out, str, strlen(str));
+	}
+
+	int outPrintf(outbuffer* Out, const char* fmt, ...) {
+		char s[STRING_LENGTH];
+		int length;
+		va_list args;
+		va_start(args, fmt);
+		length = vsnprintf(s, STRING_LENGTH, fmt, args);
+		va_end(args);
+		if (length < 0 || length >= STRING_LENGTH) return EXIT_FAILURE;
+		return outAppend(Out, s, length);
+	}
+
+	int outFormat(outbuffer* Out, const char* format, int inverted) {
+		if (format && !format[0]) format = NULL; // "" is the same as no formatting
+		if (inverted == Out->inverted && (format == Out->format || (format && Out->format && strcmp(format, Out->format) == 0)))
+			return EXIT_SUCCESS; // Already in effect
+
+		// Formats are made of several attributes, so always start from a clean slate.
+		if ((Out->format || Out->inverted) && FAILED(outPuts(Out, UNFORMAT))) return EXIT_FAILURE;
+		if (inverted && FAILED(outPuts(Out, INVERTCOLOURS))) return EXIT_FAILURE;
+		if (format && FAILED(outPuts(Out, format))) return EXIT_FAILURE;
+		Out->format = format;
+		Out->inverted = inverted;
+		return EXIT_SUCCESS;
+	}
+
+	int outFlush(outbuffer* Out, int fd) {
+		size_t written = 0;
+		ssize_t r;
+		fflush(stdout); // Anything printed before this frame must come out before it
+		while (written < Out->length) {
+			r = write(fd, Out->data + written, Out->length - written);
+			if (r < 0) {
+				if (errno == EINTR) continue;
+				Out->length = 0;
+				return EXIT_FAILURE;
+			}
+			written += r;
+		}
+		STAT_COUNT(bytes, written);
+		Out->length = 0;
+		return EXIT_SUCCESS;
+	}
+
+
+	const char* inLine(inbuffer* In, int fd, size_t* length) {
+		const char* line;
+		const char* newline;
+		size_t available, limit;
+		ssize_t r;
+
+		while (1) {
+			available = In->length - In->start;
+			limit = (available < STRING_LENGTH-1) ? available : STRING_LENGTH-1;
+			newline = available ? memchr(In->data + In->start, '\n', limit) : NULL;
+			if (newline || available >= STRING_LENGTH-1 || (In->eof && available)) {
+				line = In->data + In->start;
+				*length = newline ? (size_t) (newline - line) + 1 : limit;
+				In->start += *length;
+				return line;
+			}
+			if (In->eof) return NULL;
+
+			/* Need more: keep the partial line, and let out everything so far before waiting */
+			if (In->start) {
+				memmove(In->data, In->data + In->start, available);
+				In->length = available;
+				In->start = 0;
+			}
+			if (In->size - In->length < IN_BLOCK) {
+				char* data = realloc(In->data, In->length + IN_BLOCK);
+				if (!data) return NULL;
+				In->data = data;
+				In->size = In->length + IN_BLOCK;
+			}
+			if (FAILED(flushOutput())) return NULL;
+			r = read(fd, In->data + In->length, In->size - In->length);
+			if (r < 0 && errno == EINTR) continue;
+			if (r <= 0) In->eof = 1; // Errors end the input, as they do for fgets()
+			else In->length += r;
+		}
+	}
+
+	int readKeys(inbuffer* In, int fd, long long deadline) {
+		struct pollfd Poll = {fd, POLLIN, 0};
+		long long wait;
+		ssize_t r;
+		int ready, timeout;
+
+		if (In->start == In->length) In->start = In->length = 0; // All handled, so start the buffer again
+		while (!In->eof) {
+			/* Wait as long as it takes for the first key, then only until the frame is due */
+			if (In->start == In->length) timeout = -1;
+			else if ((wait = deadline - statsNow()) <= 0) break;
+			else timeout = (int) ((wait + 999999) / 1000000);
+			ready = poll(&Poll, 1, timeout);
+			if (ready < 0 && errno == EINTR) {
+				if (screenResized && In->start == In->length) break; // Redraw now, rather than at the next key
+				continue;
+			}
+			if (ready < 0) return EXIT_FAILURE;
+			if (!ready) break; // Nothing more before the frame is due
+
+			if (In->size - In->length < KEY_BLOCK) {
+				char* data = realloc(In->data, In->length + KEY_BLOCK);
+				if (!data) return EXIT_FAILURE;
+				In->data = data;
+				In->size = In->length + KEY_BLOCK;
+			}
+			r = read(fd, In->data + In->length, In->size - In->length);
+			if (r < 0 && errno == EINTR) continue;
+			if (r <= 0) In->eof = 1;
+			else In->length += r;
+			if (STATS_ON && !Stats.keyStart) Stats.keyStart = statsNow(); // Timed until the frame it causes is written out
+		}
+		return EXIT_SUCCESS;
+	}
+
+	int keyByte(inbuffer* In, int fd) {
+		while (In->start == In->length) {
+			if (In->eof || FAILED(readKeys(In, fd, 0))) return EOF;
+		}
+		return (unsigned char) In->data[In->start++];
+	}
+
+	int scanCommand(const char* line, size_t length, char* command, point* Point) {
+		const char* end = memchr(line, '\0', length); // sscanf() would stop at a nul
+		int* fields[2] = {&Point->x, &Point->y};
+		unsigned long value, limit;
+		int count = 0, negative, i;
+
+		if (!end) end = line + length;
+		if (line == end) return -1;
+		*command = *line++;
+		count++;
+		for (i=0; i<2; i++) {
+			while (line < end && isspace((unsigned char) *line)) line++;
+			negative = 0;
+			if (line < end && (*line == '-' || *line == '+')) negative = (*line++ == '-');
+			if (line == end || !isdigit((unsigned char) *line)) return count;
+
+			/* Like strtol(), which sscanf() uses: clamp to a long, then the long is cut down to an int */
+			limit = negative ? (unsigned long) LONG_MAX + 1 : LONG_MAX;
+			for (value = 0; line < end && isdigit((unsigned char) *line); line++) {
+				value = (value > (limit - (*line - '0')) / 10) ? limit : value * 10 + (*line - '0');
+			}
+			*fields[i] = (int) (negative ? (long) (0 - value) : (long) value);
+			count++;
+		}
+		return count;
+	}
+
+	void protocolExit(const char* msg, int exitcode) {
+		flushOutput();
+		fatal(msg, exitcode);
+	}
+
+	int flushOutput(void) {
+		int result = flushJournal(&gameJournal);
+		if (FAILED(outFlush(&frameBuffer, STDOUT_FILENO))) result = EXIT_FAILURE;
+		return result;
+	}
+
+	int replay(const char* path, int game, long long moves) {
+		struct timespec start, stop;
+		replayinfo Info;
+		settings Settings;
+		field Field;
+		point Cursor = {-1, -1}; // No cursor to draw
+
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		if (FAILED(replayJournal(path, game, moves, &Field, &Settings, &Info))) {
+			fprintf(stderr, "Could not replay game %d from %s\n", game, path);
+			return EXIT_FAILURE;
+		}
+		clock_gettime(CLOCK_MONOTONIC, &stop);
+
+		/* Draw just the frame we stopped at, as a simple grid dump */
+		Settings.options = (Settings.options & GAME_OPTIONS) | SIMPLE_OUTPUT | BORDER;
+		if (Info.lost) endField(Field, DISPLAYED);
+		if (FAILED(display(Field, Settings, Cursor))) return EXIT_FAILURE;
+		printf("Game %d (seed 0x%016" PRIx64 "): replayed %lld of %lld moves in %.1f us. %s\n", game, Settings.seed,
+		       Info.applied, Info.moves, (stop.tv_sec - start.tv_sec) * 1e6 + (stop.tv_nsec - start.tv_nsec) / 1e3,
+		       Info.lost ? "Lost." : (checkWin(Field, Settings) > 0) ? "Won." : "In progress.");
+		freeField(&Field);
+		return EXIT_SUCCESS;
 	}
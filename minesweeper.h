@@ -2,6 +2,11 @@
 	#ifndef MINESWEEPER_H
 	#define MINESWEEPER_H
 
+	/* Standard Headers */
+		#include <stddef.h>
+		#include <stdint.h>
+		#include <stdio.h>
+
 	/* Type Definitions */
 
 		enum display {
@@ -15,6 +20,17 @@
 			int y;
 		} point; // A coordinate type.
 
+		enum engineerror {
+			ENGINE_MINE = -1, // Not an error as such: a mine was revealed
+			ENGINE_NO_MEMORY = -2,
+			ENGINE_OUT_OF_FIELD = -3, // A point outside the field was given
+			ENGINE_UNCOVER = -4, // A FRAGILE game was given a pointless move
+			ENGINE_BAD_FIELD = -5, // The field contradicts itself (eg. a mine next to a zero)
+			ENGINE_BAD_STATE = -6, // The gamestate counters don't match the field
+			ENGINE_TOO_DENSE = -9, // A NO_GUESS field couldn't be laid out around the first reveal (-7 and -8 are libminesweeper's own)
+			ENGINE_OVER_REVEALED = -10 // Fewer squares are hidden or flagged than there are mines
+		}; // Negative results from engine functions that return a value or an error
+
 		#define EXPAND_ZEROES 1 // When set, hitting a 0 will hit all squares around it
 		#define GENERATE_MINES 2 // When set, program will autogenerate mine positions instead of prompting.
 		#define VERBOSE_SETUP 4 // When set, will ask user nice questions rather than expecting simply formatted inputs.
@@ -25,56 +41,417 @@
 		#define FRAGILE	128 // When set, program will report error and quit at the slightest provocation.
 		#define USE_STDERR 256 // When set, program will print errors to stderr instead of stdout.
 		#define STRICT_WIN_CHECKS 512 // When set, all remaining mines must be flagged before the game will end. And you cannot make more flags than there are mines.
+		#define FIXED_SEED 1024 // When set, the field is generated from Settings.seed instead of a random seed.
+		#define NO_GUESS 2048 // When set, generated fields can be solved without guessing, from an opening revealed in the middle.
+		#define SAFE_START 4096 // When set, the field is generated on the first reveal, with no mines on or around that square (which is then the NO_GUESS opening).
 
-		#define DEFAULT_INTERACTIVE EXPAND_ZEROES | GENERATE_MINES | VERBOSE_SETUP | FORMATTING | USE_STDERR | BORDER
+		#define DEFAULT_INTERACTIVE EXPAND_ZEROES | GENERATE_MINES | SAFE_START | VERBOSE_SETUP | FORMATTING | USE_STDERR | BORDER
 		#define DEFAULT_NOT_TTY BORDER | SIMPLE_INPUT | SIMPLE_OUTPUT | FRAGILE | STRICT_WIN_CHECKS
 
+		#define GAME_OPTIONS (EXPAND_ZEROES | GENERATE_MINES | FRAGILE | STRICT_WIN_CHECKS | NO_GUESS | SAFE_START) // Options that change the rules, not the interface
+
+		#define ENGINE_OPTIONS (EXPAND_ZEROES | FRAGILE | STRICT_WIN_CHECKS) // Options setPointTo() and checkWin() follow
+		#define RENDER_OPTIONS (SIMPLE_OUTPUT | SIMPLE_INPUT | BORDER | FORMATTING) // Options display() follows
+
 		#define HAS_OPTION(Settings, flag) ((Settings).options & (flag))
+		#define SPECIALISED static inline __attribute__((always_inline)) /* For the general form of a function, taking
+			its options as an argument: each caller that passes constant options gets its own copy, with them folded in. */
+
+		#define JOURNAL_MAGIC "MSWPJRN1" // Start of a journal file
+
+		enum journalop {
+			JOURNAL_REVEAL = 0,
+			JOURNAL_FLAG,
+			JOURNAL_MINE, // A mine placed by hand, when not GENERATE_MINES
+			JOURNAL_GAME // The start of a new game
+		}; // What a journal record is
 
 		typedef struct {
 			point fieldSize;
-			int mines; // number of mines
+			long long mines; // number of mines
 			unsigned int options; // bit-flags for extended options
+			uint64_t seed; // Seed the field was (or, with FIXED_SEED, will be) generated from
 		} settings; // Struct containing game settings
 
 		typedef struct {
-			int value; // Number of adjacent mines. -1 for a mine.
-			enum display Display;
-		} minepoint;
+			uint64_t s[4];
+		} rng; // State of a xoshiro256** random number generator
+
+		#define MINEPOINT_VALUE 0x0F // Bits of a minepoint holding the number of adjacent mines
+		#define MINEPOINT_MINE 0x0F // Value bits of a mine
+		#define MINEPOINT_DISPLAY_SHIFT 4 // The enum display is stored in the two bits above the value
+
+		typedef unsigned char minepoint; /* A packed square: number of adjacent mines (or MINEPOINT_MINE) and its display.
+		                                    Always use the accessors below rather than the bits directly. */
+
+		typedef struct {
+			long long hidden; // Number of HIDDEN squares
+			long long flagged; // Number of FLAGGED squares
+			long long correctFlags; // Number of FLAGGED squares that are mines
+		} gamestate; // Counters kept up to date as squares change, so nothing needs to scan the field
+
+		#define TILE_SHIFT 6
+		#define TILE_SIZE (1 << TILE_SHIFT) // Width and height of a tile. Must be 64, so a row of a tile's mines fits a uint64_t.
+		#define TILE_MASK (TILE_SIZE - 1)
+
+		typedef struct {
+			point Position; // Which tile this is: field coordinates >> TILE_SHIFT
+			minepoint points[TILE_SIZE * TILE_SIZE]; // y-major. Squares past the edge of the field are unused.
+		} tile; // A square chunk of the field. Tiles are only created when something looks at them.
+
+		typedef uint64_t change; /* A square whose display changed: its offset (y * width + x) above the low CHANGE_SHIFT bits,
+		                            and its minepoint after the change in them */
+		#define CHANGE_SHIFT 8
+		#define CHANGE_OFFSET(Change) ((long long) ((Change) >> CHANGE_SHIFT))
+		#define CHANGE_MINEPOINT(Change) ((minepoint) (Change))
+
+		typedef struct {
+			change* changes; // In the order they happened. A square may be in more than once.
+			size_t length;
+			size_t size;
+			int overflowed; // Set if a change was lost for want of memory, so the whole field has to be looked at instead
+		} changeset; // A reusable list of changes made to a field
+
+		#define SUMMARY_FINER 1364 // Blocks of levels 1 to TILE_SHIFT-1 in a tile: 32*32 + 16*16 + 8*8 + 4*4 + 2*2
+
+		typedef struct {
+			uint16_t shown; // DISPLAYED squares
+			uint16_t flagged; // FLAGGED squares
+		} blockcount;
+
+		typedef struct {
+			int level; // The block is 2^level squares on a side
+			point Block; // Which block: field coordinates >> level
+			long long shown;
+			long long flagged;
+			blockcount* finer; // For blocks of level TILE_SHIFT: the blocks of each smaller level in them, level 1 first
+		} summaryblock;
+
+		typedef struct {
+			summaryblock** blocks; // Hash table of blocks of level TILE_SHIFT and up, with NULL for empty slots
+			size_t slots; // Size of blocks. Always a power of 2.
+			size_t count; // Number of blocks in blocks
+			int top; // Level at which the whole field is one block
+			int failed; // Set if a change was lost for want of memory, so the counts can't be trusted
+		} summary; /* Counts of shown and flagged squares for every 2^level block of the field, like mipmaps, so an
+		              overview of any size of field costs only what it draws. Blocks with nothing counted are left out. */
+
+		typedef struct {
+			point fieldSize;
+			long long mines; // Total number of mines in the field
+			uint64_t seed; // Tiles are generated from this, if generate is set
+			int generate; // When set, new tiles have mines placed from seed. Otherwise they start empty.
+			int pending; // Set while a SAFE_START field waits for its first reveal (see firstReveal())
+			point safe; // Square whose 3x3 the seed's mines are moved out of, or -1s for none
+			enum display ending; // Display given to mines in any tile created after the game is over (HIDDEN while playing)
+			tile** tiles; // Hash table of tiles, keyed by Position, with NULL for empty slots
+			size_t tileSlots; // Size of tiles. Always a power of 2.
+			size_t tileCount; // Number of tiles in tiles
+			tile* lastTile; // Most recently looked up tile, which is usually the next one wanted
+			gamestate State;
+			changeset* Changes; // Where every change of display is recorded, or NULL (see watchField())
+			summary* Summary; // Counts of each block's displays, or NULL when not kept (see summariseField())
+			void* snapshot; // Mapped snapshot file that loaded tiles live in, or NULL
+			size_t snapshotSize;
+		} playfield;
+
+		typedef playfield* field; // The play field
+
+		typedef struct {
+			int (*setPointTo)(field Field, settings Settings, point Point, enum display Display);
+			int (*checkWin)(field Field, settings Settings);
+		} enginevariant; // setPointTo() and checkWin(), as specialised for one set of ENGINE_OPTIONS. See chooseEngine().
+
+		typedef struct {
+			int fd; // Journal file, or -1 when not journalling
+			char* data; // Records not yet written
+			size_t length;
+			size_t size;
+		} journal; // A move journal being written. See journal.c for the format.
+
+		typedef struct {
+			long long moves; // Moves in the game
+			long long applied; // How many of them were replayed
+			int lost; // Set if the last move replayed revealed a mine
+		} replayinfo;
 
-		typedef minepoint* field; // The play field
+		#define SNAPSHOT_MAGIC "MSWPSNAP"
+		#define SNAPSHOT_VERSION 1
+		#define SNAPSHOT_BYTE_ORDER 0x01020304 // Reads back differently on a machine of the other endianness
+
+		typedef struct {
+			char magic[8]; // SNAPSHOT_MAGIC, without its nul
+			uint32_t version;
+			uint32_t byteOrder;
+			uint32_t tileBytes; // sizeof(tile) for the writer
+			uint32_t ending; // Field's ending
+			int32_t width;
+			int32_t height;
+			int64_t mines;
+			uint64_t options;
+			uint64_t seed; // Settings' seed
+			uint64_t fieldSeed; // Field's seed, which tiles not in the snapshot are generated from
+			uint64_t generate;
+			int64_t hidden;
+			int64_t flagged;
+			int64_t correctFlags;
+			uint64_t tileCount;
+			uint32_t pending; // Field's pending
+			uint32_t hasSafe; // Set if safeX and safeY are Field's safe square (older snapshots have none)
+			int32_t safeX;
+			int32_t safeY;
+			char reserved[8];
+		} snapshotheader; /* Start of a snapshot file. The file is this, then tileCount tiles exactly as they are in memory.
+		                     Tiles not in the file have never been looked at, so they are generated as usual. */
+
+		typedef struct {
+			const char** displayString; // (fmt, str) pair last drawn to this terminal cell, or NULL if unknown
+			int inverted; // Whether it was drawn with inverted colours (ie. under the cursor)
+		} screencell; // One cell of the shadow screen buffer used by new_display()
+
+		typedef int (*renderer)(field Field, settings Settings, point Cursor); // Draws a frame for display(). See chooseRenderer().
+
+		typedef struct {
+			char* data;
+			size_t length; // Bytes currently buffered
+			size_t size; // Bytes allocated
+			const char* format; // Formatting escapes currently in effect on the terminal, or NULL for none
+			int inverted; // Whether INVERTCOLOURS is currently in effect
+		} outbuffer; // A reusable buffer that a whole frame is composed into before being written out at once
+
+		#define STATS_ENV "MINESWEEPER_STATS" // Set to 1 to print stats to stderr on exit, or to a path to append them to
+		#define STATS_BUCKETS 488 // Enough for any long long, at 8 buckets per power of 2
+
+		typedef struct {
+			long long count;
+			long long sum;
+			long long max;
+			long long buckets[STATS_BUCKETS]; // Values are accurate to within 1/8 once bucketed
+		} histogram;
+
+		typedef struct {
+			int enabled; // Nothing is recorded unless this is set
+			long long frames; // display() calls
+			long long bytes; // Written out by outFlush(), in total
+			long long setPointTo; // setPointTo() calls
+			long long expansions; // expandZeroes() calls
+			long long expansionDepth; // Most seeds expandZeroes() has had waiting at once
+			long long keyStart; // When the keystroke now being handled was read, or 0
+			histogram FrameBytes; // Bytes written per frame
+			histogram DisplayTime; // Nanoseconds per display()
+			histogram ExpansionCells; // Cells revealed per expandZeroes()
+			histogram CheckWinTime; // Nanoseconds per checkWin()
+			histogram KeyLatency; // Nanoseconds from reading a keystroke to its frame being written out
+		} stats; /* Counters and timers for finding out why the game is slow. Turned on by STATS_ENV.
+		            Only the terminal front-end turns them on, as it has just the one thread. */
+
+		/* Stats macros: a predictable branch, and nothing more, while stats are off */
+		#define STATS_ON (Stats.enabled && !statsPaused) // Whether this thread records stats now
+		#define STAT_COUNT(counter, n) do { if (STATS_ON) Stats.counter += (n); } while (0) // Add n to a counter
+		#define STAT_MAX(counter, n) do { if (STATS_ON && (n) > Stats.counter) Stats.counter = (n); } while (0) // Raise a counter to n
+		#define STAT_VALUE(Histogram, value) do { if (STATS_ON) statsRecord(&Stats.Histogram, (value)); } while (0) // Add a value to a histogram
+		#define STAT_START(var) long long var = STATS_ON ? statsNow() : 0 // Declare var, holding the time if stats are on
+		#define STAT_TIME(Histogram, start) STAT_VALUE(Histogram, statsNow() - (start)) // Add the time since start to a histogram
+
+		typedef struct {
+			char* data;
+			size_t start; // Offset of the next unread byte
+			size_t length; // Bytes currently buffered, including those already read
+			size_t size; // Bytes allocated
+			int eof; // Set once the input has ended (or failed)
+		} inbuffer; // Input read in large blocks, then handed out a line at a time
 
 	/*Primitives*/
 		/* Semantics note: The phrase "returns success" refers to the practice
 		   of returning an int EXIT_SUCCESS or EXIT_FAILURE from a function */
 
-		int set_termios(void); // Setup termios as wanted
-		void unset_termios(void); // Restore original termios
-		void fatal(const char* msg, int exitcode); // Abort program after printing error message, using given exit code.
-		int setup(field* Field, settings* Settings); // Set up program, ready to begin.
-		int setSettings(settings* Settings); // Sets game settings. Returns success.
-		int askSetting(int* ptr, char* name, int min, int max); /* Prompt user for a single game setting,
-		                                                           setting ptr to it. Returns success. */
+		/* Engine (engine.c) */
+		/* None of these exit or print. fatal() is only here for the front-ends and tools that link the engine. */
+		extern _Thread_local FILE* err_file; // Where fatal() reports errors, per thread. Set by the front-end, else stderr.
+		__attribute__((noreturn)) void fatal(const char* msg, int exitcode); // Abort program after printing error message, using given exit code.
+		const char* engineError(int error); // Returns the message for an enum engineerror.
 		int createField(field* Field, settings Settings); // Constructor for field. Puts new, empty field in Field.
 		int freeField(field* Field); // Gracefully destroy field and it's components.
-		int buildField(field Field, settings Settings, int seed); /* Populate field with mines and sets values,
-		                                                             using RNG seeded with given seed. Returns success.*/
-		int promptMines(field Field, settings Settings); // Populate field from simple user input. Returns success.
-		int play(field Field, settings Settings); // Main game loop. Returns 1 to play again, 0 to exit, -1 on error.
-		void simplePlay(field Field, settings Settings); // Main game loop for SIMPLE_INPUT.
+		int buildField(field Field, settings Settings, uint64_t seed); /* Populate field with mines and sets values,
+		                                                                  using RNG seeded with given seed. Returns success.
+		                                                                  Tiles are actually generated as they are first used,
+		                                                                  except for NO_GUESS fields (see noGuessField()).
+		                                                                  With SAFE_START, waits for firstReveal(). */
+		int firstReveal(field Field, settings Settings, point Point); /* Finish a SAFE_START field's buildField() with no mines
+		                                                                  on or next to Point, changing only the squares that
+		                                                                  differ in tiles that already exist. Called by
+		                                                                  setPointTo(). Returns 0 or an enum engineerror. */
+		uint64_t randomSeed(void); // Returns a fresh seed from the OS, so games started together still differ.
 		minepoint* getMinepoint(point Point, field Field, point FieldSize); /* Return the minepoint at given point,
-		                                                                       or NULL for out of bounds. */
+		                                                                       or NULL for out of bounds (or out of
+		                                                                       memory to generate its tile). */
 		int point2offset(point Point, int ysize); /* Takes a point and returns the linear offset that would represent
 		                                             that point in a 2d y-major array with a max y of ysize */
+		tile* getTile(field Field, point Position, int create); /* Return the tile at given tile position. If it doesn't
+		                                                           exist yet, create and generate it if create is set,
+		                                                           else return NULL. */
+		int addTile(field Field, tile* Tile); // Add a finished tile to Field's table. Returns success.
+		point getTileSize(field Field, point Position); // Returns how much of a tile is actually on the field.
+		void generateTile(field Field, tile* Tile); /* Set the values in a tile from the mines in it and its neighbours.
+		                                               A new tile's mines are placed from Field's seed first. */
+		void recountField(field Field); // Set the values in every tile, after mines have been placed by hand.
+		void neighbourCounts(const unsigned char* mines, int stride, minepoint* out, int outStride, int width, int height); /*
+			Set the value bits of width x height minepoints in out from a grid of 1s for mines, which has a one square
+			border around them (so it is (width+2) x (height+2)). Uses SSE2/AVX2 where available. */
+		void tileMines(field Field, point Position, uint64_t* rows); /* Fill rows (TILE_SIZE of them) with a bitmap of
+		                                                                the mines in a tile, whether it exists or not. */
+		void seedMines(field Field, point Position, uint64_t* rows); /* Fill rows with the mines the seed puts in a tile,
+		                                                                moved out of the 3x3 around Field's safe square. */
+		int minesAround(field Field, point Point); // Returns the number of mines next to Point, without creating any tiles.
+		long long tileMineCount(field Field, point Position); // Returns the number of mines the seed puts in a tile.
+		long long tileCellsBefore(field Field, long long index); /* Returns the number of squares in all tiles before
+		                                                            the tile with given row-major index. */
+		long long splitMines(uint64_t key, long long mines, long long cells, long long leftCells); /*
+			Returns how many of mines randomly placed in cells land in the first leftCells of them,
+			drawn from the random stream key. Exactly hypergeometric, however many there are. */
+		double logFactorial(long long n); // Returns log(n!). Safe to call from several threads.
+		uint64_t mix64(uint64_t x); // Hashes x (the splitmix64 finaliser). Used to derive independent stream keys.
+		void rngSeed(rng* Rng, uint64_t key); // Start Rng on the stream for key. Different keys give independent streams.
+		uint64_t rngNext(rng* Rng); // Returns the next 64 random bits.
+		uint64_t rngBelow(rng* Rng, uint64_t n); // Returns a uniform integer in [0, n), without modulo bias. n must be > 0.
+		double rngDouble(rng* Rng); // Returns a uniform double in [0, 1).
 		int isMine(minepoint MinePoint); // Returns 1 if MinePoint is a mine, else 0.
+		int getValue(minepoint MinePoint); // Returns the number of mines adjacent to MinePoint, or -1 if it is a mine.
+		void setValue(minepoint* MinePoint, int value); // Set the number of adjacent mines, or -1 to make it a mine.
+		enum display getDisplay(minepoint MinePoint); // Returns MinePoint's display.
+		void setDisplay(field Field, point Point, minepoint* MinePoint, enum display Display); /* Set the display of
+			the minepoint at Point, keeping Field's gamestate up to date and recording the change if Field is watched.
+			Every change of display goes through here. */
+		void watchField(field Field, changeset* Changes); /* Record every change of display in Field into Changes,
+			until called again (with NULL to stop). Mines in tiles made after endField() are recorded when their tile is. */
+		void recordChange(changeset* Changes, long long offset, minepoint MinePoint); // Append a change, or set overflowed.
+		void clearChanges(changeset* Changes); // Empty Changes for reuse, keeping its memory.
+		void freeChanges(changeset* Changes); // Free Changes' memory, leaving it empty.
 		int setPointTo(field Field, settings Settings, point Point, enum display Display); /*
-			Set given point's display. Return value at point (that was just changed) (-1 on mine).
-			May expand zeroes, recursively. */
-		int checkWin(field Field, settings Settings); // Return 1 if user has won, else 0.
+			Set given point's display. Return value at point (that was just changed) (ENGINE_MINE on mine),
+			or another enum engineerror. May expand zeroes. */
+		int expandZeroes(field Field, settings Settings, point Start); /* Reveal the hidden zero at Start and everything
+		                                                                  connected to it by zeroes. Returns the number
+		                                                                  of cells revealed, or an enum engineerror. */
+		int checkWin(field Field, settings Settings); // Return 1 if user has won, 0 if not, or an enum engineerror.
+		const enginevariant* chooseEngine(settings Settings); /* Returns the engine specialised for Settings' ENGINE_OPTIONS,
+			if they are those of DEFAULT_INTERACTIVE or DEFAULT_NOT_TTY, else one that is just setPointTo() and checkWin(). */
+		int checkState(field Field, settings Settings); /* Returns 0, or ENGINE_BAD_STATE if Field's gamestate doesn't
+		                                                   match a full count. For debugging. */
+		void endField(field Field, enum display Display); // Set all mines (hidden mines, for DISPLAYED) to Display, including future tiles.
+		int saveField(field Field, settings Settings, const char* path); /* Write a snapshot of the game to path.
+		                                                                    The old file is only replaced once the new
+		                                                                    one is complete. Returns success. */
+		int loadField(field* Field, settings* Settings, const char* path); /* Create a field from a snapshot, mapping its
+		                                                                      tiles straight from the file (copy-on-write).
+		                                                                      Returns success; leaves Field and Settings
+		                                                                      alone on failure. */
+		int validTile(const tile* Tile); // Returns 1 if every square in Tile holds a legal value and display, else 0.
+		int writeAll(int fd, const void* data, size_t length); // write() all of data, despite short writes. Returns success.
+
+		/* No-guess generation (noguess.c) */
+		int noGuessField(field Field, settings Settings, uint64_t seed, point Opening); /* Lay out mines from seed so the
+			field can be solved by deduction alone, once Opening (which is kept clear) is revealed. The same seed and
+			Opening always give the same field. Used by buildField() and firstReveal() for NO_GUESS. Returns success. */
+
+		/* Field summary (summary.c) */
+		int summariseField(field Field); /* Start keeping Field->Summary up to date, from the tiles made so far
+		                                    (or start again, if it failed). Returns success. */
+		void freeSummary(field Field); // Stop keeping Field->Summary, and free it.
+		void summaryChange(field Field, point Point, int shown, int flagged); /* Add to the counts for every block
+		                                                                         holding Point. Called by setDisplay(). */
+		void summaryCounts(field Field, int level, point Block, long long* shown, long long* flagged); /*
+			Set the number of shown and flagged squares in a 2^level block. The rest of it is hidden. */
+		summaryblock* getSummaryBlock(summary* Summary, int level, point Block, int create); /* Return a block of level
+			TILE_SHIFT or up. If it doesn't exist yet, add it if create is set, else return NULL. */
+
+		/* Stats (stats.c) */
+		extern stats Stats; // Everything recorded so far. See the stats macros.
+		extern _Thread_local int statsPaused; // Set while this thread's moves aren't the player's, so aren't recorded.
+		int statsStart(void); // Turn stats on if STATS_ENV asks for them, and dump them at exit. Returns success.
+		void statsRecord(histogram* Histogram, long long value); // Add a value (clamped to 0) to Histogram.
+		long long statsPercentile(const histogram* Histogram, double fraction); /* Returns the value that fraction
+		                                                                           of Histogram's values are at or
+		                                                                           below (to within 1/8). */
+		void statsDump(FILE* file); // Write a summary of Stats to file.
+		long long statsNow(void); // Monotonic time, in nanoseconds.
+
+		/* Journal (journal.c) */
+		int openJournal(journal* Journal, const char* path); /* Open path to append games to, creating it if needed.
+		                                                        Returns success. */
+		int journalGame(journal* Journal, settings Settings); // Record the start of a new game. Returns success.
+		int journalMove(journal* Journal, enum journalop Op, point Point); // Record a move. Returns success.
+		int journalVarint(journal* Journal, uint64_t value); // Append a varint. Returns success.
+		int journalBytes(journal* Journal, const void* data, size_t length); // Append raw bytes. Returns success.
+		int flushJournal(journal* Journal); // Write out records so far. Returns success.
+		int closeJournal(journal* Journal); // Flush and close. Safe to call when not journalling. Returns success.
+		int readVarint(const unsigned char** data, const unsigned char* end, uint64_t* value); /* Read a varint at *data,
+		                                                                                          moving *data past it.
+		                                                                                          Returns success. */
+		int replayJournal(const char* path, int game, long long moves, field* Field, settings* Settings, replayinfo* Info); /*
+			Rebuild the game-th game (from 1) in a journal by re-applying its first moves moves (all if negative).
+			Nothing is drawn. Puts the result in Field and Settings. Returns success. */
+
+		/* Terminal front-end (minesweeper.c) */
+		extern renderer Renderer; // How display() draws. drawFrame(), unless main() chose one for its options.
+		int set_termios(void); // Setup termios as wanted
+		void unset_termios(void); // Restore original termios
+		int setup(field* Field, settings* Settings); // Set up program, ready to begin.
+		int setSettings(settings* Settings); // Sets game settings. Returns success.
+		int askSetting(long long* ptr, char* name, long long min, long long max); /* Prompt user for a single game setting,
+		                                                                             setting ptr to it. Returns success. */
+		int promptMines(field Field, settings Settings); // Populate field from simple user input. Returns success.
+		int play(field* Field, settings* Settings); /* Main game loop. Returns 1 to play again, 0 to exit, -1 on error.
+		                                               Field and Settings are replaced if a saved game is loaded. */
+		void simplePlay(field Field, settings Settings); // Main game loop for SIMPLE_INPUT.
 		int win(field Field, settings Settings, point Cursor); // Do stuff for winning
 		int lose(field Field, settings Settings, point Cursor); // Do stuff for losing
-		int display(field Field, settings Settings, point Cursor); // Draw the game field to the screen.
+		int display(field Field, settings Settings, point Cursor); // Draw the game field to the screen, with Renderer.
+		renderer chooseRenderer(settings Settings); /* Returns the renderer specialised for Settings' RENDER_OPTIONS,
+			if they are those of DEFAULT_INTERACTIVE or DEFAULT_NOT_TTY, else drawFrame(). */
+		int drawFrame(field Field, settings Settings, point Cursor); // Draw with simple_display() or new_display(), as Settings say.
+		int drawInteractive(field Field, settings Settings, point Cursor); // new_display(), for DEFAULT_INTERACTIVE
+		int drawNotTty(field Field, settings Settings, point Cursor); // simple_display(), for DEFAULT_NOT_TTY
+		int simple_display(field Field, settings Settings); // Draw the game field as a SIMPLE_OUTPUT grid dump.
+		int new_display(field Field, settings Settings, point Cursor); /* Draw the game field to the terminal,
+		                                                                   only redrawing cells that have changed. */
+		void resetDisplay(void); // Forget what is on screen, so the next new_display() redraws everything.
+		const char** getScreenStr(field Field, settings Settings, point Point); /* Returns the string to display for
+		                                                                           a given point, which may be off-field. */
+		const char** getBlockStr(field Field, settings Settings, int level, point Block); /* Returns the string to display
+			for a 2^level block of squares (see summaryCounts()), which may be off-field. Field must have a Summary. */
+		const char** getBorderStr(settings Settings, point Point, point Size); /* Returns the string to display at
+		                                                                          a point off a field of Size. */
 		const char** getStr(minepoint MinePoint); // Returns the string to display for a given minepoint.
-		point getScreenSize(void); // Returns the size of the terminal window for stdout, or {-1, -1} on error.
+		point getScreenSize(void); /* Returns the size of the terminal window for stdout, or {-1, -1} on error.
+		                              Only asks the terminal again after a SIGWINCH (see watchScreenSize()). */
+		int watchScreenSize(void); // Catch SIGWINCH, so getScreenSize() knows when to ask again. Returns success.
+		void onResize(int signal); // SIGWINCH handler.
+		int outAppend(outbuffer* Out, const char* str, size_t length); // Append length bytes of str. Returns success.
+		int outPuts(outbuffer* Out, const char* str); // Append a string. Returns success.
+		int outPrintf(outbuffer* Out, const char* fmt, ...); // Append printf-formatted output. Returns success.
+		int outFormat(outbuffer* Out, const char* format, int inverted); /* Switch formatting to format (and inverted),
+		                                                                   only emitting escapes if it changed. Returns success. */
+		int outFlush(outbuffer* Out, int fd); /* Write the whole buffer to fd with as few write()s as possible
+		                                         (after flushing stdio). Returns success. */
+		const char* inLine(inbuffer* In, int fd, size_t* length); /* Returns the next line of input (not nul-terminated),
+		                                                             split just as fgets() into a STRING_LENGTH buffer
+		                                                             would, or NULL at end of input. Writes out
+		                                                             frameBuffer and the journal before waiting for
+		                                                             more input. */
+		int readKeys(inbuffer* In, int fd, long long deadline); /* Wait for a keystroke, then take everything typed until
+		                                                           deadline (a statsNow() time) into In, so it can all
+		                                                           be handled before the next frame. Returns early,
+		                                                           with nothing, if the terminal is resized while
+		                                                           waiting. Returns success. */
+		int keyByte(inbuffer* In, int fd); // Returns the next byte typed, waiting for it if need be, or EOF.
+		int scanCommand(const char* line, size_t length, char* command, point* Point); /*
+			Parse a SIMPLE_INPUT line of the form "c x y" exactly as sscanf(line, "%c %d %d", ...) would.
+			Returns the number of fields read, or -1 for an empty line. */
+		__attribute__((noreturn)) void protocolExit(const char* msg, int exitcode); // Write out pending SIMPLE_INPUT output and journal, then fatal().
+		int flushOutput(void); // Write out frameBuffer and the journal. Returns success.
+		int replay(const char* path, int game, long long moves); /* Replay a game from a journal up to a given move
+		                                                           (all if negative), then draw that one frame.
+		                                                           Returns success. */
 
 	#endif
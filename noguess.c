@@ -0,0 +1,234 @@
+	/*
+		No-guess field generation: fields that can be finished by deduction alone, from a safe opening.
+		Each candidate is a random layout with no mines around the opening. The solver plays it using
+		deduction only; where it gets stuck, a mine on the stuck frontier is moved out to a square
+		nobody can see yet (or in, from there, if the frontier has no mines), and it tries again.
+		Only after enough repairs fail is the candidate thrown away for the next.
+		Candidates are searched on several threads at once. Each candidate's layout and repairs come
+		from the seed and its index alone, and the lowest index that works is kept, so the same seed
+		always gives the same field, however many threads found it.
+	*/
+
+	/* Header File contains solver structs and function prototypes (and includes the engine's) */
+		#include "solver.h"
+
+	/* Standard Headers */
+		#include <stdlib.h>
+		#include <string.h>
+		#include <limits.h>
+		#include <unistd.h>
+		#include <pthread.h>
+
+	/*Macros*/
+		#define FAILED(x) ((x) != EXIT_SUCCESS) // Macro for checking if a function call did not return EXIT_SUCCESS
+		#define NOGUESS_CANDIDATES 2000 // Give up (the field is too dense) after this many candidates
+		#define NOGUESS_REPAIRS 200 // Moves of a mine tried on one candidate before the next
+		#define NOGUESS_MAX_THREADS 16
+		#define NOGUESS_NODE_LIMIT 20000 // Solver->nodeLimit. A frontier that takes longer than this to enumerate gets repaired instead.
+
+	/* Type Definitions */
+		typedef struct {
+			settings Settings; // Settings to solve candidates with
+			point Opening;
+			uint64_t seed;
+			int cells;
+			pthread_mutex_t lock; // Guards everything below
+			long long next; // Next candidate to try
+			long long found; // Lowest candidate that worked, or LLONG_MAX
+			unsigned char* layout; // Its mines: 1 for each square that is one
+			int failed; // Set on running out of memory
+		} noguess;
+
+		void* searchCandidates(void* arg); // Thread body: try candidates until a lower one than any left has worked.
+		int tryCandidate(noguess* Search, solver* Solver, long long index, unsigned char* mines, int* scratch); /*
+			Lay out and repair candidate index in mines. Returns 1 if it needs no guesses, 0 if not, -1 on error. */
+		int repairCandidate(noguess* Search, solver* Solver, unsigned char* mines, int* scratch, rng* Rng); /*
+			Move one mine to or from where Solver got stuck. Returns 1 if one was moved, else 0. */
+		int inOpening(noguess* Search, int offset); // Returns 1 if the square at offset must be kept clear of mines.
+
+	/*Methods*/
+
+	int noGuessField(field Field, settings Settings, uint64_t seed, point Opening) {
+		noguess Search;
+		pthread_t Threads[NOGUESS_MAX_THREADS];
+		long threads = sysconf(_SC_NPROCESSORS_ONLN), clear = 0;
+		point Point;
+		minepoint* MinePoint;
+		int i, result = EXIT_FAILURE, paused = statsPaused;
+
+		Search.Settings = Settings;
+		Search.Settings.options = EXPAND_ZEROES; // Just the rules that matter for deduction
+		Search.Opening = Opening;
+		Search.seed = seed;
+		if ((long long) Settings.fieldSize.x * Settings.fieldSize.y > INT_MAX / 8) return EXIT_FAILURE; // Too big for the solver
+		Search.cells = Settings.fieldSize.x * Settings.fieldSize.y;
+		for (i=0; i<Search.cells; i++) clear += inOpening(&Search, i);
+		if (Settings.mines > Search.cells - clear) return EXIT_FAILURE; // No room for the mines around the opening
+		Search.next = 0;
+		Search.found = LLONG_MAX;
+		Search.failed = 0;
+		if (!(Search.layout = malloc(Search.cells))) return EXIT_FAILURE;
+		pthread_mutex_init(&Search.lock, NULL);
+
+		/* This thread searches too, alongside the others. Their moves aren't the player's, so they stay out of the stats
+		   (searchCandidates() pauses them for its own thread, without touching the other threads' games). */
+		if (threads < 1) threads = 1;
+		if (threads > NOGUESS_MAX_THREADS) threads = NOGUESS_MAX_THREADS;
+		for (i=1; i<threads; i++) {
+			if (pthread_create(&Threads[i], NULL, searchCandidates, &Search)) break;
+		}
+		threads = i;
+		searchCandidates(&Search);
+		for (i=1; i<threads; i++) pthread_join(Threads[i], NULL);
+		pthread_mutex_destroy(&Search.lock);
+		statsPaused = paused;
+		if (Search.failed || Search.found == LLONG_MAX) goto done;
+
+		/* Lay the winner out by hand. Any tiles already drawn are empty, but may have flags on them. */
+		Field->seed = seed;
+		Field->mines = Settings.mines;
+		Field->generate = 0;
+		for (i=0; i<Search.cells; i++) {
+			if (!Search.layout[i]) continue;
+			Point.x = i % Settings.fieldSize.x;
+			Point.y = i / Settings.fieldSize.x;
+			if (!(MinePoint = getMinepoint(Point, Field, Settings.fieldSize))) goto done;
+			setValue(MinePoint, -1);
+			if (getDisplay(*MinePoint) == FLAGGED) Field->State.correctFlags++;
+		}
+		recountField(Field);
+		result = EXIT_SUCCESS;
+
+	done:
+		free(Search.layout);
+		return result;
+	}
+
+	void* searchCandidates(void* arg) {
+		noguess* Search = arg;
+		solver* Solver = NULL;
+		unsigned char* mines = malloc(Search->cells);
+		int* scratch = malloc(Search->cells * sizeof(int));
+		long long index;
+		int result;
+
+		statsPaused = 1;
+		if (!mines || !scratch || FAILED(createSolver(&Solver, Search->Settings.fieldSize))) {
+			pthread_mutex_lock(&Search->lock);
+			Search->failed = 1;
+			pthread_mutex_unlock(&Search->lock);
+		}
+		if (Solver) Solver->nodeLimit = NOGUESS_NODE_LIMIT;
+		while (Solver) {
+			pthread_mutex_lock(&Search->lock);
+			index = Search->next++;
+			if (Search->failed || index >= Search->found || index >= NOGUESS_CANDIDATES) index = -1; // Nothing left worth trying
+			pthread_mutex_unlock(&Search->lock);
+			if (index < 0) break;
+
+			result = tryCandidate(Search, Solver, index, mines, scratch);
+			pthread_mutex_lock(&Search->lock);
+			if (result < 0) Search->failed = 1;
+			if (result > 0 && index < Search->found) {
+				Search->found = index;
+				memcpy(Search->layout, mines, Search->cells);
+			}
+			pthread_mutex_unlock(&Search->lock);
+		}
+
+		freeSolver(&Solver);
+		free(mines);
+		free(scratch);
+		return NULL;
+	}
+
+	int tryCandidate(noguess* Search, solver* Solver, long long index, unsigned char* mines, int* scratch) {
+		settings Settings = Search->Settings;
+		solvestats Stats;
+		field Field;
+		point Point;
+		minepoint* MinePoint;
+		rng Rng;
+		int allowed = 0, i, j, repairs, won, beaten;
+
+		/* Spread the mines over every square outside the opening, as buildField() would */
+		rngSeed(&Rng, mix64(Search->seed) ^ mix64((uint64_t) index));
+		memset(mines, 0, Search->cells);
+		for (i=0; i<Search->cells; i++) {
+			if (!inOpening(Search, i)) scratch[allowed++] = i;
+		}
+		for (i = allowed - Settings.mines; i < allowed; i++) {
+			j = rngBelow(&Rng, i + 1);
+			if (mines[scratch[j]]) j = i; // Already chosen, so take the new square instead
+			mines[scratch[j]] = 1;
+		}
+
+		for (repairs = 0; repairs <= NOGUESS_REPAIRS; repairs++) {
+			if (FAILED(createField(&Field, Settings))) return -1;
+			Field->mines = Settings.mines;
+			for (i=0; i<Search->cells; i++) {
+				if (!mines[i]) continue;
+				Point.x = i % Settings.fieldSize.x;
+				Point.y = i / Settings.fieldSize.x;
+				if (!(MinePoint = getMinepoint(Point, Field, Settings.fieldSize))) goto failed;
+				setValue(MinePoint, -1);
+			}
+			recountField(Field);
+
+			solverReset(Solver);
+			if (setPointTo(Field, Settings, Search->Opening, DISPLAYED) < 0) goto failed;
+			if (solverDeduce(Solver, Field, Settings, &Stats) < 0 || (won = checkWin(Field, Settings)) < 0) goto failed;
+			freeField(&Field);
+			if (won) return 1;
+
+			/* Stuck. Another candidate may well be done before this one is. */
+			pthread_mutex_lock(&Search->lock);
+			beaten = (Search->found < index);
+			pthread_mutex_unlock(&Search->lock);
+			if (beaten || !repairCandidate(Search, Solver, mines, scratch, &Rng)) return 0;
+		}
+		return 0;
+
+	failed:
+		freeField(&Field);
+		return -1;
+	}
+
+	int repairCandidate(noguess* Search, solver* Solver, unsigned char* mines, int* scratch, rng* Rng) {
+		/* scratch gets the stuck frontier's mines, then its safe squares, from each end,
+		   and then the unseen squares that are safe, then that are mines */
+		int frontierMines = 0, frontierSafe = 0, unseenSafe = 0, unseenMines = 0, i, from, to;
+		int* unseen;
+
+		for (i=0; i<Search->cells; i++) {
+			if (Solver->values[i] >= 0 || Solver->known[i] != UNKNOWN || !Solver->cellConstraintCount[i]) continue;
+			if (mines[i]) scratch[frontierMines++] = i;
+			else scratch[Search->cells - 1 - frontierSafe++] = i;
+		}
+		unseen = scratch + frontierMines;
+		for (i=0; i<Search->cells; i++) {
+			if (Solver->values[i] >= 0 || Solver->known[i] != UNKNOWN || Solver->cellConstraintCount[i] || inOpening(Search, i)) continue;
+			if (!mines[i]) unseen[unseenSafe++] = i;
+		}
+		for (i=0; i<Search->cells; i++) {
+			if (Solver->values[i] >= 0 || Solver->known[i] != UNKNOWN || Solver->cellConstraintCount[i] || inOpening(Search, i)) continue;
+			if (mines[i]) unseen[unseenSafe + unseenMines++] = i;
+		}
+		if (frontierMines && unseenSafe) {
+			from = scratch[rngBelow(Rng, frontierMines)];
+			to = unseen[rngBelow(Rng, unseenSafe)];
+		} else if (frontierSafe && unseenMines) {
+			from = unseen[unseenSafe + rngBelow(Rng, unseenMines)];
+			to = scratch[Search->cells - 1 - rngBelow(Rng, frontierSafe)];
+		} else {
+			return 0; // Nowhere to move a mine to
+		}
+		mines[from] = 0;
+		mines[to] = 1;
+		return 1;
+	}
+
+	int inOpening(noguess* Search, int offset) {
+		int x = offset % Search->Settings.fieldSize.x, y = offset / Search->Settings.fieldSize.x;
+		return x >= Search->Opening.x - 1 && x <= Search->Opening.x + 1 && y >= Search->Opening.y - 1 && y <= Search->Opening.y + 1;
+	}
@@ -0,0 +1,557 @@
+	/*
+		An automatic player, working through the same engine as a human player.
+		It only ever looks at what a player could see: revealed values and its own deductions.
+		Deductions are tried cheapest first: single constraints, then overlapping pairs,
+		then exact enumeration of each independent part of the frontier, which also gives
+		the mine probabilities used when it has to guess.
+	*/
+
+	/* Header File contains solver structs and function prototypes (and includes the engine's) */
+		#include "solver.h"
+
+	/* Standard Headers */
+		#include <stdlib.h>
+		#include <stdio.h>
+		#include <string.h>
+		#include <math.h>
+
+	/*Macros*/
+		#define FAILED(x) ((x) != EXIT_SUCCESS) // Macro for checking if a function call did not return EXIT_SUCCESS
+		#define DEFAULT_NODE_LIMIT 2000000 // Default Solver->nodeLimit
+
+	/* Type Definitions */
+		typedef struct {
+			int n; // Number of squares in the component
+			int* cells; // Their offsets, in search order
+			int* cellConstraints; // Up to 8 local constraint indexes per square
+			unsigned char* cellConstraintCount;
+			int* need; // Mines each constraint still needs
+			int* left; // Squares each constraint still has unassigned
+			unsigned char* assignment; // 1 for each square currently assigned a mine
+			double* solutions; // Number of solutions with k mines, for k = 0...n
+			double* cellMines; // Number of solutions with k mines where square j is a mine, at [j*(n+1) + k]
+			long long nodes; // Search steps so far
+			long long nodeLimit;
+		} search; // An exact enumeration of one independent part of the frontier
+
+		void searchComponent(search* Search, int i, int mines); // Enumerate assignments of squares i... Called recursively.
+		double logChoose(long long n, long long k); // Returns log(n choose k), or -INFINITY if k is out of range.
+		int findRoot(int* parent, int i); // Union-find lookup, with path halving.
+
+	/*Methods*/
+
+	int createSolver(solver** Solver, point fieldSize) {
+		int cells = fieldSize.x * fieldSize.y;
+		if (!(*Solver = calloc(1, sizeof(solver)))) return EXIT_FAILURE;
+		(*Solver)->fieldSize = fieldSize;
+		(*Solver)->cells = cells;
+		(*Solver)->nodeLimit = DEFAULT_NODE_LIMIT;
+		(*Solver)->values = malloc(cells * sizeof(signed char));
+		(*Solver)->known = malloc(cells);
+		(*Solver)->safe = malloc(cells * sizeof(int));
+		(*Solver)->constraints = malloc(cells * sizeof(constraint));
+		(*Solver)->cellConstraints = malloc(cells * 8 * sizeof(int));
+		(*Solver)->cellConstraintCount = malloc(cells);
+		(*Solver)->probability = malloc(cells * sizeof(double));
+		(*Solver)->component = malloc(cells * sizeof(int));
+		if (!(*Solver)->values || !(*Solver)->known || !(*Solver)->safe || !(*Solver)->constraints ||
+		    !(*Solver)->cellConstraints || !(*Solver)->cellConstraintCount || !(*Solver)->probability || !(*Solver)->component) {
+			freeSolver(Solver);
+			return EXIT_FAILURE;
+		}
+		solverReset(*Solver);
+		return EXIT_SUCCESS;
+	}
+
+	void freeSolver(solver** Solver) {
+		if (*Solver) {
+			free((*Solver)->values);
+			free((*Solver)->known);
+			free((*Solver)->safe);
+			free((*Solver)->constraints);
+			free((*Solver)->cellConstraints);
+			free((*Solver)->cellConstraintCount);
+			free((*Solver)->probability);
+			free((*Solver)->component);
+		}
+		free(*Solver);
+		*Solver = NULL;
+	}
+
+	void solverReset(solver* Solver) {
+		memset(Solver->known, UNKNOWN, Solver->cells);
+		Solver->safeCount = 0;
+		Solver->knownMines = 0;
+		Solver->constraintCount = 0;
+	}
+
+	int solveGame(solver* Solver, field Field, settings Settings, point First, solvestats* Stats) {
+		int result;
+		solverReset(Solver);
+		Stats->clicks = 1;
+		Stats->guesses = 1;
+		Stats->revealed = 0;
+
+		if ((result = setPointTo(Field, Settings, First, DISPLAYED)) < 0) return (result == ENGINE_MINE) ? 0 : -1;
+		while (!(result = checkWin(Field, Settings))) {
+			if (solverDeduce(Solver, Field, Settings, Stats) < 0) return -1;
+			if ((result = checkWin(Field, Settings))) break;
+			switch (solverGuess(Solver, Field, Settings, Stats)) {
+				case -1:
+					return 0; // Unlucky
+				case -2:
+					return -1;
+				default:
+					break;
+			}
+		}
+		if (result < 0) return -1;
+		Stats->revealed = (long long) Settings.fieldSize.x * Settings.fieldSize.y - Field->State.hidden - Field->State.flagged;
+		return 1;
+	}
+
+	int solverDeduce(solver* Solver, field Field, settings Settings, solvestats* Stats) {
+		int clicks = 0, learned, won, i;
+		point Point;
+		minepoint* MinePoint;
+
+		while (1) {
+			if (FAILED(solverRefresh(Solver, Field, Settings))) return -1;
+			if (!(learned = solverTrivial(Solver)) && !(learned = solverPairs(Solver))) {
+				if ((learned = solverProbabilities(Solver, Settings)) < 0) return -1;
+			}
+			if (!learned) return clicks; // Stuck
+
+			for (i=0; i<Solver->safeCount; i++) {
+				Point.x = Solver->safe[i] % Solver->fieldSize.x;
+				Point.y = Solver->safe[i] / Solver->fieldSize.x;
+				if (!(MinePoint = getMinepoint(Point, Field, Settings.fieldSize))) return -1;
+				if (getDisplay(*MinePoint) == DISPLAYED) continue; // Zero expansion got it
+				if (setPointTo(Field, Settings, Point, DISPLAYED) < 0) return -1; // A "safe" square was a mine, or an error
+				clicks++;
+				Stats->clicks++;
+			}
+			Solver->safeCount = 0;
+			if ((won = checkWin(Field, Settings))) return (won < 0) ? -1 : clicks;
+		}
+	}
+
+	int solverGuess(solver* Solver, field Field, settings Settings, solvestats* Stats) {
+		int i, best = -1, bestNeighbours = 9, neighbours, dx, dy, x, y, value;
+		double bestProbability = 2;
+		point Point;
+
+		if (FAILED(solverRefresh(Solver, Field, Settings)) || solverProbabilities(Solver, Settings) < 0) return -2;
+		if (Solver->safeCount) {
+			best = Solver->safe[0]; // Can only happen if the last deduction was cut short by a win check
+		} else {
+			/* Frontier squares first, then any unconstrained square if that's better, preferring ones with few neighbours */
+			for (i=0; i<Solver->cells; i++) {
+				if (Solver->values[i] >= 0 || Solver->known[i] != UNKNOWN || !Solver->cellConstraintCount[i]) continue;
+				if (Solver->probability[i] < bestProbability) {
+					bestProbability = Solver->probability[i];
+					best = i;
+				}
+			}
+			if (Solver->unconstrainedProbability < bestProbability) {
+				for (i=0; i<Solver->cells; i++) {
+					if (Solver->values[i] >= 0 || Solver->known[i] != UNKNOWN || Solver->cellConstraintCount[i]) continue;
+					x = i % Solver->fieldSize.x;
+					y = i / Solver->fieldSize.x;
+					neighbours = 0;
+					for (dy=-1; dy<=1; dy++) for (dx=-1; dx<=1; dx++) {
+						neighbours += (dx || dy) && x+dx >= 0 && x+dx < Solver->fieldSize.x && y+dy >= 0 && y+dy < Solver->fieldSize.y;
+					}
+					if (neighbours < bestNeighbours) {
+						bestNeighbours = neighbours;
+						best = i;
+					}
+				}
+			}
+		}
+		if (best < 0) return -2; // Nothing left to guess - the game should have been won
+
+		Point.x = best % Solver->fieldSize.x;
+		Point.y = best / Solver->fieldSize.x;
+		Stats->clicks++;
+		Stats->guesses++;
+		Solver->safeCount = 0;
+		value = setPointTo(Field, Settings, Point, DISPLAYED);
+		return (value < ENGINE_MINE) ? -2 : value;
+	}
+
+	int solverRefresh(solver* Solver, field Field, settings Settings) {
+		int i, dx, dy, x, y, offset;
+		point Point;
+		minepoint* MinePoint;
+		constraint* Constraint;
+
+		/* What can the player see? */
+		for (Point.y=0; Point.y<Settings.fieldSize.y; Point.y++) for (Point.x=0; Point.x<Settings.fieldSize.x; Point.x++) {
+			if (!(MinePoint = getMinepoint(Point, Field, Settings.fieldSize))) return EXIT_FAILURE;
+			Solver->values[point2offset(Point, Settings.fieldSize.x)] = (getDisplay(*MinePoint) == DISPLAYED) ? getValue(*MinePoint) : -1;
+		}
+
+		/* Every revealed number next to unknown squares says how many of them are mines */
+		Solver->constraintCount = 0;
+		memset(Solver->cellConstraintCount, 0, Solver->cells);
+		for (i=0; i<Solver->cells; i++) {
+			if (Solver->values[i] <= 0) continue; // Hidden, or a zero (which can't border anything unknown)
+			Constraint = &Solver->constraints[Solver->constraintCount];
+			Constraint->count = 0;
+			Constraint->mines = Solver->values[i];
+			x = i % Solver->fieldSize.x;
+			y = i / Solver->fieldSize.x;
+			for (dy=-1; dy<=1; dy++) for (dx=-1; dx<=1; dx++) {
+				if (x+dx < 0 || x+dx >= Solver->fieldSize.x || y+dy < 0 || y+dy >= Solver->fieldSize.y) continue;
+				offset = i + dy*Solver->fieldSize.x + dx;
+				if (Solver->values[offset] >= 0) continue; // Revealed
+				if (Solver->known[offset] == KNOWN_MINE) Constraint->mines--;
+				else if (Solver->known[offset] == UNKNOWN) Constraint->cells[Constraint->count++] = offset;
+			}
+			if (!Constraint->count) continue;
+			for (dx=0; dx<Constraint->count; dx++) {
+				offset = Constraint->cells[dx];
+				Solver->cellConstraints[offset*8 + Solver->cellConstraintCount[offset]++] = Solver->constraintCount;
+			}
+			Solver->constraintCount++;
+		}
+		return EXIT_SUCCESS;
+	}
+
+	int solverLearn(solver* Solver, int offset, enum knowledge Knowledge) {
+		if (Solver->known[offset] != UNKNOWN) return 0;
+		Solver->known[offset] = Knowledge;
+		if (Knowledge == KNOWN_SAFE) Solver->safe[Solver->safeCount++] = offset;
+		else Solver->knownMines++;
+		return 1;
+	}
+
+	int solverTrivial(solver* Solver) {
+		int i, j, learned = 0;
+		constraint* Constraint;
+		for (i=0; i<Solver->constraintCount; i++) {
+			Constraint = &Solver->constraints[i];
+			if (Constraint->mines == 0) {
+				for (j=0; j<Constraint->count; j++) learned += solverLearn(Solver, Constraint->cells[j], KNOWN_SAFE);
+			} else if (Constraint->mines == Constraint->count) {
+				for (j=0; j<Constraint->count; j++) learned += solverLearn(Solver, Constraint->cells[j], KNOWN_MINE);
+			}
+		}
+		return learned;
+	}
+
+	int solverPairs(solver* Solver) {
+		/* For constraints A and B: B's squares outside A hold at least B.mines - A.mines mines.
+		   If that is all of them, they are all mines, and A's mines must all be shared, so A's squares outside B are safe.
+		   With A a subset of B, this is the usual subset rule. */
+		int a, b, i, j, k, learned = 0;
+		int onlyA[8], onlyB[8], onlyACount, onlyBCount;
+		constraint *A, *B;
+
+		for (a=0; a<Solver->constraintCount; a++) {
+			A = &Solver->constraints[a];
+			for (i=0; i<A->count; i++) {
+				for (k=0; k<Solver->cellConstraintCount[A->cells[i]]; k++) {
+					b = Solver->cellConstraints[A->cells[i]*8 + k];
+					if (b == a) continue;
+					B = &Solver->constraints[b];
+
+					onlyACount = onlyBCount = 0;
+					for (j=0; j<A->count; j++) {
+						int shared = 0, l;
+						for (l=0; l<B->count; l++) shared |= (A->cells[j] == B->cells[l]);
+						if (!shared) onlyA[onlyACount++] = A->cells[j];
+					}
+					for (j=0; j<B->count; j++) {
+						int shared = 0, l;
+						for (l=0; l<A->count; l++) shared |= (B->cells[j] == A->cells[l]);
+						if (!shared) onlyB[onlyBCount++] = B->cells[j];
+					}
+
+					if (B->mines - A->mines == onlyBCount && (onlyACount || onlyBCount)) {
+						for (j=0; j<onlyBCount; j++) learned += solverLearn(Solver, onlyB[j], KNOWN_MINE);
+						for (j=0; j<onlyACount; j++) learned += solverLearn(Solver, onlyA[j], KNOWN_SAFE);
+					}
+				}
+			}
+		}
+		return learned;
+	}
+
+	int solverProbabilities(solver* Solver, settings Settings) {
+		int* parent = Solver->component;
+		int *frontier = NULL, *compOf = NULL, *compStart = NULL, *compConstraints = NULL, *compConstraintStart = NULL;
+		int* localIndex = NULL;
+		unsigned char* visited = NULL;
+		search* Searches = NULL;
+		double *B = NULL, *Q = NULL, *R = NULL, *conv = NULL;
+		int frontierCount = 0, compCount = 0, i, j, k, c, d, m, root, result = -1, aborted = 0, learned = 0;
+		long long unconstrained = 0, mines = Settings.mines - Solver->knownMines, s, S;
+		double maxLog, total, weight, notWeight;
+
+		/* Join squares sharing a constraint into independent components */
+		for (i=0; i<Solver->cells; i++) parent[i] = i;
+		for (i=0; i<Solver->constraintCount; i++) {
+			for (j=1; j<Solver->constraints[i].count; j++) {
+				int a = findRoot(parent, Solver->constraints[i].cells[0]), b = findRoot(parent, Solver->constraints[i].cells[j]);
+				if (a != b) parent[b] = a;
+			}
+		}
+
+		frontier = malloc(Solver->cells * sizeof(int));
+		compOf = malloc(Solver->cells * sizeof(int));
+		localIndex = malloc(Solver->cells * sizeof(int));
+		visited = calloc(Solver->cells, 1);
+		compStart = malloc((Solver->cells + 1) * sizeof(int));
+		compConstraintStart = malloc((Solver->cells + 1) * sizeof(int));
+		compConstraints = malloc((Solver->constraintCount + 1) * sizeof(int));
+		if (!frontier || !compOf || !localIndex || !visited || !compStart || !compConstraintStart || !compConstraints) goto cleanup;
+
+		/* Number the components, and count the squares that aren't in any */
+		for (i=0; i<Solver->cells; i++) compOf[i] = -1;
+		for (i=0; i<Solver->cells; i++) {
+			if (Solver->values[i] >= 0 || Solver->known[i] != UNKNOWN) continue;
+			if (!Solver->cellConstraintCount[i]) {
+				unconstrained++;
+				continue;
+			}
+			root = findRoot(parent, i);
+			if (compOf[root] < 0) compOf[root] = compCount++;
+			compOf[i] = compOf[root];
+			frontierCount++;
+		}
+
+		/* Group the constraints by component, then put each component's squares in breadth-first order
+		   (so constraints are completed early in the search, and it can prune) */
+		memset(compConstraintStart, 0, (compCount + 1) * sizeof(int));
+		for (i=0; i<Solver->constraintCount; i++) compConstraintStart[compOf[Solver->constraints[i].cells[0]] + 1]++;
+		for (c=0; c<compCount; c++) compConstraintStart[c+1] += compConstraintStart[c];
+		for (c=0; c<=compCount; c++) compStart[c] = compConstraintStart[c]; // Borrowed as fill positions
+		for (i=0; i<Solver->constraintCount; i++) compConstraints[compStart[compOf[Solver->constraints[i].cells[0]]]++] = i;
+
+		if (!(Searches = calloc(compCount + 1, sizeof(search)))) goto cleanup;
+		compStart[0] = 0;
+		for (c=0; c<compCount; c++) {
+			int head, tail;
+			search* Search = &Searches[c];
+			/* Breadth-first from the first square of the first constraint */
+			head = tail = compStart[c];
+			i = Solver->constraints[compConstraints[compConstraintStart[c]]].cells[0];
+			visited[i] = 1;
+			frontier[tail++] = i;
+			while (head < tail) {
+				i = frontier[head++];
+				for (k=0; k<Solver->cellConstraintCount[i]; k++) {
+					constraint* Constraint = &Solver->constraints[Solver->cellConstraints[i*8 + k]];
+					for (j=0; j<Constraint->count; j++) {
+						if (visited[Constraint->cells[j]]) continue;
+						visited[Constraint->cells[j]] = 1;
+						frontier[tail++] = Constraint->cells[j];
+					}
+				}
+			}
+			compStart[c+1] = tail;
+
+			/* Set up the search in local terms */
+			Search->n = tail - compStart[c];
+			Search->cells = &frontier[compStart[c]];
+			Search->nodeLimit = Solver->nodeLimit;
+			for (j=0; j<Search->n; j++) localIndex[Search->cells[j]] = j;
+			m = compConstraintStart[c+1] - compConstraintStart[c];
+			Search->cellConstraints = malloc(Search->n * 8 * sizeof(int));
+			Search->cellConstraintCount = calloc(Search->n, 1);
+			Search->need = malloc(m * sizeof(int));
+			Search->left = malloc(m * sizeof(int));
+			Search->assignment = calloc(Search->n, 1);
+			Search->solutions = calloc(Search->n + 1, sizeof(double));
+			Search->cellMines = calloc((size_t) Search->n * (Search->n + 1), sizeof(double));
+			if (!Search->cellConstraints || !Search->cellConstraintCount || !Search->need || !Search->left ||
+			    !Search->assignment || !Search->solutions || !Search->cellMines) goto cleanup;
+			for (k=0; k<m; k++) {
+				constraint* Constraint = &Solver->constraints[compConstraints[compConstraintStart[c] + k]];
+				Search->need[k] = Constraint->mines;
+				Search->left[k] = Constraint->count;
+				for (j=0; j<Constraint->count; j++) {
+					int local = localIndex[Constraint->cells[j]];
+					Search->cellConstraints[local*8 + Search->cellConstraintCount[local]++] = k;
+				}
+			}
+
+			searchComponent(Search, 0, 0);
+			if (Search->nodes > Search->nodeLimit) aborted = 1;
+		}
+
+		if (aborted) {
+			/* Too many possibilities to count exactly. Fall back on each square's most pessimistic constraint. */
+			double expected = 0;
+			for (i=0; i<frontierCount; i++) {
+				int offset = frontier[i];
+				double p = 0;
+				for (k=0; k<Solver->cellConstraintCount[offset]; k++) {
+					constraint* Constraint = &Solver->constraints[Solver->cellConstraints[offset*8 + k]];
+					if ((double) Constraint->mines / Constraint->count > p) p = (double) Constraint->mines / Constraint->count;
+				}
+				Solver->probability[offset] = p;
+				expected += p;
+			}
+			Solver->unconstrainedProbability = unconstrained ? (mines - expected) / unconstrained : 1;
+			if (Solver->unconstrainedProbability < 0) Solver->unconstrainedProbability = 0;
+			result = 0;
+			goto cleanup;
+		}
+
+		/* Weight each total number of frontier mines s by the ways to place the rest among the unconstrained squares */
+		S = frontierCount;
+		B = malloc((S + 1) * sizeof(double));
+		Q = malloc((S + 1) * sizeof(double));
+		R = malloc((S + 1) * sizeof(double));
+		conv = malloc((S + 1) * sizeof(double));
+		if (!B || !Q || !R || !conv) goto cleanup;
+		maxLog = -INFINITY;
+		for (s=0; s<=S; s++) {
+			B[s] = logChoose(unconstrained, mines - s);
+			if (B[s] > maxLog) maxLog = B[s];
+		}
+		if (maxLog == -INFINITY) goto cleanup; // No way to place the mines at all - our knowledge is wrong
+		for (s=0; s<=S; s++) B[s] = exp(B[s] - maxLog);
+
+		/* Scale each component's counts down, so their products can't overflow. Ratios are all that matter. */
+		for (c=0; c<compCount; c++) {
+			double max = 0;
+			for (k=0; k<=Searches[c].n; k++) if (Searches[c].solutions[k] > max) max = Searches[c].solutions[k];
+			if (max == 0) goto cleanup; // No solutions - our knowledge is wrong
+			for (k=0; k<=Searches[c].n; k++) Searches[c].solutions[k] /= max;
+			for (k=0; k<Searches[c].n * (Searches[c].n + 1); k++) Searches[c].cellMines[k] /= max;
+		}
+
+		/* For each component, combine all the others (Q), then weight each of its own mine counts by them (R) */
+		total = -1;
+		for (c=0; c<compCount; c++) {
+			int qLength = 1;
+			Q[0] = 1;
+			for (d=0; d<compCount; d++) {
+				if (d == c) continue;
+				for (s=0; s<qLength + Searches[d].n; s++) conv[s] = 0;
+				for (s=0; s<qLength; s++) for (k=0; k<=Searches[d].n; k++) conv[s+k] += Q[s] * Searches[d].solutions[k];
+				qLength += Searches[d].n;
+				memcpy(Q, conv, qLength * sizeof(double));
+			}
+			for (k=0; k<=Searches[c].n; k++) {
+				R[k] = 0;
+				for (s=0; s<qLength; s++) R[k] += Q[s] * B[k+s];
+			}
+			if (total < 0) {
+				total = 0;
+				for (k=0; k<=Searches[c].n; k++) total += Searches[c].solutions[k] * R[k];
+				if (total <= 0) goto cleanup;
+
+				/* The unconstrained squares, from the combination of everything */
+				weight = notWeight = 0;
+				for (k=0; k<=Searches[c].n; k++) for (s=0; s<qLength; s++) {
+					weight += Searches[c].solutions[k] * Q[s] * B[k+s] * (mines - k - s);
+					notWeight += Searches[c].solutions[k] * Q[s] * B[k+s] * (unconstrained - (mines - k - s));
+				}
+				Solver->unconstrainedProbability = unconstrained ? weight / total / unconstrained : 1;
+				if (unconstrained && (weight == 0 || notWeight == 0)) {
+					for (i=0; i<Solver->cells; i++) {
+						if (Solver->values[i] >= 0 || Solver->cellConstraintCount[i]) continue;
+						learned += solverLearn(Solver, i, weight == 0 ? KNOWN_SAFE : KNOWN_MINE);
+					}
+				}
+			}
+			for (j=0; j<Searches[c].n; j++) {
+				weight = notWeight = 0;
+				for (k=0; k<=Searches[c].n; k++) {
+					weight += Searches[c].cellMines[j*(Searches[c].n+1) + k] * R[k];
+					notWeight += (Searches[c].solutions[k] - Searches[c].cellMines[j*(Searches[c].n+1) + k]) * R[k];
+				}
+				Solver->probability[Searches[c].cells[j]] = weight / total;
+				if (weight == 0) learned += solverLearn(Solver, Searches[c].cells[j], KNOWN_SAFE);
+				else if (notWeight == 0) learned += solverLearn(Solver, Searches[c].cells[j], KNOWN_MINE);
+			}
+		}
+		if (!compCount) {
+			/* No frontier at all: every unknown square is alike */
+			Solver->unconstrainedProbability = unconstrained ? (double) mines / unconstrained : 1;
+			if (unconstrained && (mines == 0 || mines == unconstrained)) {
+				for (i=0; i<Solver->cells; i++) {
+					if (Solver->values[i] >= 0 || Solver->known[i] != UNKNOWN) continue;
+					learned += solverLearn(Solver, i, mines == 0 ? KNOWN_SAFE : KNOWN_MINE);
+				}
+			}
+		}
+		result = learned;
+
+	cleanup:
+		if (Searches) {
+			for (c=0; c<compCount; c++) {
+				free(Searches[c].cellConstraints);
+				free(Searches[c].cellConstraintCount);
+				free(Searches[c].need);
+				free(Searches[c].left);
+				free(Searches[c].assignment);
+				free(Searches[c].solutions);
+				free(Searches[c].cellMines);
+			}
+			free(Searches);
+		}
+		free(frontier);
+		free(compOf);
+		free(localIndex);
+		free(visited);
+		free(compStart);
+		free(compConstraintStart);
+		free(compConstraints);
+		free(B);
+		free(Q);
+		free(R);
+		free(conv);
+		return result;
+	}
+
+	void searchComponent(search* Search, int i, int mines) {
+		int value, k, j, ok;
+		int* constraints;
+
+		if (++Search->nodes > Search->nodeLimit) return; // Give up
+		if (i == Search->n) {
+			Search->solutions[mines]++;
+			for (j=0; j<Search->n; j++) {
+				if (Search->assignment[j]) Search->cellMines[j*(Search->n+1) + mines]++;
+			}
+			return;
+		}
+
+		constraints = &Search->cellConstraints[i*8];
+		for (value=0; value<=1; value++) {
+			ok = 1;
+			for (k=0; k<Search->cellConstraintCount[i]; k++) {
+				Search->need[constraints[k]] -= value;
+				Search->left[constraints[k]]--;
+				if (Search->need[constraints[k]] < 0 || Search->need[constraints[k]] > Search->left[constraints[k]]) ok = 0;
+			}
+			if (ok) {
+				Search->assignment[i] = value;
+				searchComponent(Search, i+1, mines + value);
+				Search->assignment[i] = 0;
+			}
+			for (k=0; k<Search->cellConstraintCount[i]; k++) {
+				Search->need[constraints[k]] += value;
+				Search->left[constraints[k]]++;
+			}
+		}
+	}
+
+	double logChoose(long long n, long long k) {
+		if (k < 0 || k > n) return -INFINITY;
+		return logFactorial(n) - logFactorial(k) - logFactorial(n - k);
+	}
+
+	int findRoot(int* parent, int i) {
+		while (parent[i] != i) {
+			parent[i] = parent[parent[i]];
+			i = parent[i];
+		}
+		return i;
+	}
@@ -0,0 +1,73 @@
+
+	#ifndef SOLVER_H
+	#define SOLVER_H
+
+	/* Header File contains std headers, structs, other typedefs and function prototypes */
+		#include "minesweeper.h"
+
+	/* Type Definitions */
+
+		enum knowledge {
+			UNKNOWN = 0,
+			KNOWN_SAFE,
+			KNOWN_MINE
+		}; // What the solver has worked out about a hidden square
+
+		typedef struct {
+			int cells[8]; // Unknown hidden squares around a revealed number, as offsets
+			int count; // Number of cells
+			int mines; // How many of cells are mines
+		} constraint;
+
+		typedef struct {
+			long long clicks; // Squares the solver chose to reveal
+			long long guesses; // How many of those clicks were guesses
+			long long revealed; // Squares revealed, including by zero expansion
+		} solvestats;
+
+		typedef struct {
+			point fieldSize;
+			int cells; // fieldSize.x * fieldSize.y
+			signed char* values; // What the player can see: the value of each revealed square, else -1
+			unsigned char* known; // An enum knowledge for each square
+			int* safe; // Squares known to be safe and not yet revealed
+			int safeCount;
+			long long knownMines; // Number of squares that are KNOWN_MINE
+			constraint* constraints;
+			int constraintCount;
+			int* cellConstraints; // Up to 8 constraint indexes per square
+			unsigned char* cellConstraintCount; // Number of constraints each square is in
+			double* probability; // Chance each frontier square is a mine, from the last solverProbabilities()
+			double unconstrainedProbability; // Chance any square not next to a revealed number is a mine
+			int* component; // Scratch: union-find parents, then component lists
+			long long nodeLimit; // Give up on exact enumeration of a component after this many search steps
+		} solver; // Reusable state for solving games on fields of one size
+
+	/*Primitives*/
+		/* Semantics note: The phrase "returns success" refers to the practice
+		   of returning an int EXIT_SUCCESS or EXIT_FAILURE from a function */
+
+		int createSolver(solver** Solver, point fieldSize); // Constructor for solver. Returns success.
+		void freeSolver(solver** Solver); // Destroy solver.
+		int solveGame(solver* Solver, field Field, settings Settings, point First, solvestats* Stats); /*
+			Play a whole game on a fresh field, starting by revealing First.
+			Returns 1 if the solver won, 0 if it hit a mine, -1 on error. */
+		int solverDeduce(solver* Solver, field Field, settings Settings, solvestats* Stats); /*
+			Reveal every square that can be proven safe, until no more can be.
+			Returns the number of clicks made, or -1 if a mine was hit (which means a bug) or on error. */
+		int solverGuess(solver* Solver, field Field, settings Settings, solvestats* Stats); /*
+			Reveal the square least likely to be a mine. Returns its value, -1 if it was a mine, or -2 on error. */
+		void solverReset(solver* Solver); // Forget everything, ready for a new game.
+		int solverRefresh(solver* Solver, field Field, settings Settings); /* Read what is revealed and rebuild constraints.
+		                                                                      Returns success. */
+		int solverTrivial(solver* Solver); /* Apply single-constraint rules (all safe or all mines).
+		                                      Returns number of squares learned. */
+		int solverPairs(solver* Solver); /* Apply rules from pairs of overlapping constraints, including subsets.
+		                                    Returns number of squares learned. */
+		int solverProbabilities(solver* Solver, settings Settings); /* Work out the chance of each unknown square being a
+		                                                                mine, by enumerating each independent part of the
+		                                                                frontier exactly. Marks squares that are certain.
+		                                                                Returns number of squares learned, or -1 on error. */
+		int solverLearn(solver* Solver, int offset, enum knowledge Knowledge); // Record what a square is. Returns 1 if new.
+
+	#endif
@@ -0,0 +1,113 @@
+	/*
+		Solver throughput benchmark.
+		Plays the solver through many generated fields at each standard difficulty,
+		and reports games solved per second and how often it wins.
+		Fields come from a fixed master seed (or -s), so runs are comparable.
+	*/
+
+	/* Header File contains solver structs and function prototypes (and includes the engine's) */
+		#include "solver.h"
+
+	/* Standard Headers */
+		#include <stdlib.h>
+		#include <stdio.h>
+		#include <errno.h>
+		#include <inttypes.h>
+		#include <time.h>
+		#include <unistd.h>
+
+	/*Macros*/
+		#define FAILED(x) ((x) != EXIT_SUCCESS) // Macro for checking if a function call did not return EXIT_SUCCESS
+
+	/* Type Definitions */
+		typedef struct {
+			const char* name;
+			point fieldSize;
+			long long mines;
+		} difficulty;
+
+	/*Global Variables*/
+		const difficulty Difficulties[] = {
+			{"beginner", {9, 9}, 10},
+			{"intermediate", {16, 16}, 40},
+			{"expert", {30, 16}, 99}
+		};
+
+	/*Methods*/
+
+	int main(int argc, char *argv[]) {
+		int opt, d;
+		long long games = 10000, game, wins;
+		uint64_t masterSeed = 0x5EEDULL;
+		char* end;
+		struct timespec start, stop;
+		double seconds;
+		solvestats Stats, Total;
+		settings Settings;
+		field Field;
+		solver* Solver;
+		point First;
+
+		err_file = stderr;
+		while ((opt = getopt(argc, argv, "n:s:")) != -1) {
+			switch (opt) {
+				case 'n': // Games per difficulty
+					games = strtoll(optarg, &end, 0);
+					if (*end || games <= 0) {
+						fprintf(stderr, "Invalid number of games: %s\n", optarg);
+						exit(EXIT_FAILURE);
+					}
+					break;
+				case 's': // Master seed
+					errno = 0;
+					masterSeed = strtoull(optarg, &end, 0);
+					if (errno || !*optarg || *end) {
+						fprintf(stderr, "Invalid seed: %s\n", optarg);
+						exit(EXIT_FAILURE);
+					}
+					break;
+				default:
+					fprintf(stderr, "Usage: %s [-n games] [-s seed]\n", argv[0]);
+					exit(EXIT_FAILURE);
+			}
+		}
+
+		printf("%-12s %7s %6s %10s %8s %12s %10s\n", "difficulty", "size", "mines", "games", "won", "games/s", "guesses");
+		for (d=0; d<(int) (sizeof(Difficulties)/sizeof(Difficulties[0])); d++) {
+			Settings.fieldSize = Difficulties[d].fieldSize;
+			Settings.mines = Difficulties[d].mines;
+			Settings.options = EXPAND_ZEROES | GENERATE_MINES;
+			First.x = Settings.fieldSize.x / 2;
+			First.y = Settings.fieldSize.y / 2;
+			if (FAILED(createSolver(&Solver, Settings.fieldSize))) fatal("Out of memory", EXIT_FAILURE);
+
+			wins = 0;
+			Total.clicks = Total.guesses = Total.revealed = 0;
+			clock_gettime(CLOCK_MONOTONIC, &start);
+			for (game=0; game<games; game++) {
+				Settings.seed = mix64(masterSeed ^ mix64(((uint64_t) d << 48) ^ (uint64_t) game));
+				if (FAILED(createField(&Field, Settings))) fatal("Out of memory", EXIT_FAILURE);
+				if (FAILED(buildField(Field, Settings, Settings.seed))) fatal("Could not build field", EXIT_FAILURE);
+				switch (solveGame(Solver, Field, Settings, First, &Stats)) {
+					case 1:
+						wins++;
+						break;
+					case 0:
+						break;
+					default:
+						fprintf(stderr, "Solver failed on seed 0x%016" PRIx64 "\n", Settings.seed);
+						exit(EXIT_FAILURE);
+				}
+				Total.guesses += Stats.guesses;
+				freeField(&Field);
+			}
+			clock_gettime(CLOCK_MONOTONIC, &stop);
+			seconds = (stop.tv_sec - start.tv_sec) + (stop.tv_nsec - start.tv_nsec) / 1e9;
+
+			printf("%-12s %3dx%-3d %6lld %10lld %7.2f%% %12.1f %10.2f\n", Difficulties[d].name,
+			       Settings.fieldSize.x, Settings.fieldSize.y, Settings.mines, games,
+			       100.0 * wins / games, games / seconds, (double) Total.guesses / games);
+			freeSolver(&Solver);
+		}
+		exit(EXIT_SUCCESS);
+	}
@@ -0,0 +1,108 @@
+	/*
+		Runtime stats: counters and latency histograms for the hot paths, for when the game feels slow.
+		They are always compiled in, but off unless STATS_ENV is set, and then every STAT_ macro
+		is a single branch on STATS_ON. The summary is written when the program exits.
+		Histograms keep 8 buckets per power of 2, so percentiles come out to within 1/8
+		without keeping every value.
+	*/
+
+	/* Header File contains std headers, structs, other typedefs and function prototypes */
+		#include "minesweeper.h"
+
+	/* Standard Headers */
+		#include <stdlib.h>
+		#include <stdio.h>
+		#include <string.h>
+		#include <time.h>
+
+	/* Type Definitions */
+		void statsExit(void); // atexit() handler: dump Stats to wherever STATS_ENV said.
+		void dumpHistogram(FILE* file, const char* name, const histogram* Histogram, double scale); /*
+			Write one line of the summary for Histogram, with its values divided by scale. */
+		int bucketOf(long long value); // Returns the histogram bucket holding value.
+		long long bucketTop(int bucket); // Returns the largest value that goes in bucket.
+
+	/*Global Variables*/
+		stats Stats; // Everything recorded so far. All zero (and off) to start with.
+		_Thread_local int statsPaused = 0; // Set while this thread's moves aren't the player's
+		const char* statsPath = NULL; // Where to append the summary, or NULL for stderr
+
+	/*Methods*/
+
+	int statsStart(void) {
+		const char* env = getenv(STATS_ENV);
+		if (!env || !*env || strcmp(env, "0") == 0) return EXIT_SUCCESS; // Not wanted
+		if (strcmp(env, "1") != 0) statsPath = env;
+		if (atexit(statsExit)) return EXIT_FAILURE;
+		Stats.enabled = 1;
+		return EXIT_SUCCESS;
+	}
+
+	void statsExit(void) {
+		FILE* file = stderr;
+		if (statsPath && !(file = fopen(statsPath, "a"))) return; // Nowhere to put them, and too late to complain
+		statsDump(file);
+		if (file != stderr) fclose(file);
+	}
+
+	void statsRecord(histogram* Histogram, long long value) {
+		if (value < 0) value = 0;
+		Histogram->count++;
+		Histogram->sum += value;
+		if (value > Histogram->max) Histogram->max = value;
+		Histogram->buckets[bucketOf(value)]++;
+	}
+
+	long long statsPercentile(const histogram* Histogram, double fraction) {
+		long long target = (long long) (fraction * Histogram->count + 0.999999), seen = 0;
+		int bucket;
+		if (target < 1) target = 1;
+		for (bucket = 0; bucket < STATS_BUCKETS; bucket++) {
+			if ((seen += Histogram->buckets[bucket]) >= target) break;
+		}
+		if (bucket == STATS_BUCKETS || bucketTop(bucket) > Histogram->max) return Histogram->max;
+		return bucketTop(bucket);
+	}
+
+	void statsDump(FILE* file) {
+		fprintf(file, "minesweeper stats\n");
+		fprintf(file, "  %-22s %lld\n", "frames drawn", Stats.frames);
+		fprintf(file, "  %-22s %lld\n", "bytes written", Stats.bytes);
+		fprintf(file, "  %-22s %lld\n", "setPointTo() calls", Stats.setPointTo);
+		fprintf(file, "  %-22s %lld (deepest: %lld seeds waiting)\n", "expansions", Stats.expansions, Stats.expansionDepth);
+		fprintf(file, "  %-22s %10s %12s %12s %12s %12s\n", "", "count", "mean", "p50", "p99", "max");
+		dumpHistogram(file, "bytes per frame", &Stats.FrameBytes, 1);
+		dumpHistogram(file, "display() us", &Stats.DisplayTime, 1e3);
+		dumpHistogram(file, "cells per expansion", &Stats.ExpansionCells, 1);
+		dumpHistogram(file, "checkWin() ns", &Stats.CheckWinTime, 1);
+		dumpHistogram(file, "key to screen us", &Stats.KeyLatency, 1e3);
+	}
+
+	void dumpHistogram(FILE* file, const char* name, const histogram* Histogram, double scale) {
+		if (!Histogram->count) {
+			fprintf(file, "  %-22s %10d\n", name, 0);
+			return;
+		}
+		fprintf(file, "  %-22s %10lld %12.1f %12.1f %12.1f %12.1f\n", name, Histogram->count,
+		        Histogram->sum / scale / Histogram->count, statsPercentile(Histogram, 0.5) / scale,
+		        statsPercentile(Histogram, 0.99) / scale, Histogram->max / scale);
+	}
+
+	int bucketOf(long long value) {
+		int top;
+		if (value < 8) return value;
+		top = 63 - __builtin_clzll(value); // Position of the highest set bit, at least 3
+		return 8 * (top - 2) + ((value >> (top - 3)) & 7); // Then the next 3 bits pick one of 8 buckets
+	}
+
+	long long bucketTop(int bucket) {
+		int top = bucket / 8 + 2;
+		if (bucket < 8) return bucket;
+		return ((long long) (8 + bucket % 8) << (top - 3)) + ((1LL << (top - 3)) - 1); // Never overflows, even for the last bucket
+	}
+
+	long long statsNow(void) {
+		struct timespec Time;
+		clock_gettime(CLOCK_MONOTONIC, &Time);
+		return (long long) Time.tv_sec * 1000000000LL + Time.tv_nsec;
+	}
@@ -0,0 +1,189 @@
+	/*
+		Field summary: how many squares are shown and flagged in every 2^level block of the field, for
+		drawing it zoomed out. A block of level TILE_SHIFT is a tile, and holds the counts for the smaller
+		blocks inside it; larger blocks each hold their own. Blocks are only made once something in them
+		changes, in a hash table like the tiles', so a huge field costs only what has been played of it.
+		A change adds to one block of each level, so it costs O(log size), and any block can be read at once.
+	*/
+
+	/* Header File contains std headers, structs, other typedefs and function prototypes */
+		#include "minesweeper.h"
+
+	/* Standard Headers */
+		#include <stdlib.h>
+		#include <string.h>
+
+	/*Macros*/
+		#define FAILED(x) ((x) != EXIT_SUCCESS) // Macro for checking if a function call did not return EXIT_SUCCESS
+
+	/* Type Definitions */
+		int addSummaryBlock(summary* Summary, summaryblock* Block); // Add a new block to Summary's table. Returns success.
+		int finerIndex(int level, point Point); // Returns where the level block holding Point is in its tile's finer counts.
+		uint64_t summaryKey(int level, point Position); // Returns the hash of a block.
+
+	/*Methods*/
+
+	int summariseField(field Field) {
+		point Size, Point, Square;
+		tile* Tile;
+		size_t i;
+		int j;
+
+		freeSummary(Field);
+		if (!(Field->Summary = calloc(1, sizeof(summary)))) return EXIT_FAILURE;
+		Field->Summary->slots = 64;
+		if (!(Field->Summary->blocks = calloc(Field->Summary->slots, sizeof(summaryblock*)))) {
+			freeSummary(Field);
+			return EXIT_FAILURE;
+		}
+		for (Field->Summary->top = TILE_SHIFT;
+		     ((Field->fieldSize.x - 1) >> Field->Summary->top) || ((Field->fieldSize.y - 1) >> Field->Summary->top);
+		     Field->Summary->top++);
+
+		/* Count what has been played so far. Squares in tiles not made yet are all hidden. */
+		for (i=0; i<Field->tileSlots; i++) {
+			if (!(Tile = Field->tiles[i])) continue;
+			Size = getTileSize(Field, Tile->Position);
+			for (Point.y=0; Point.y<Size.y; Point.y++) for (Point.x=0; Point.x<Size.x; Point.x++) {
+				j = getDisplay(Tile->points[(Point.y << TILE_SHIFT) | Point.x]);
+				if (j == HIDDEN) continue;
+				Square.x = (Tile->Position.x << TILE_SHIFT) | Point.x;
+				Square.y = (Tile->Position.y << TILE_SHIFT) | Point.y;
+				summaryChange(Field, Square, j == DISPLAYED, j == FLAGGED);
+			}
+		}
+		if (Field->Summary->failed) {
+			freeSummary(Field);
+			return EXIT_FAILURE;
+		}
+		return EXIT_SUCCESS;
+	}
+
+	void freeSummary(field Field) {
+		size_t i;
+		if (!Field->Summary) return;
+		if (Field->Summary->blocks) {
+			for (i=0; i<Field->Summary->slots; i++) {
+				if (!Field->Summary->blocks[i]) continue;
+				free(Field->Summary->blocks[i]->finer);
+				free(Field->Summary->blocks[i]);
+			}
+			free(Field->Summary->blocks);
+		}
+		free(Field->Summary);
+		Field->Summary = NULL;
+	}
+
+	void summaryChange(field Field, point Point, int shown, int flagged) {
+		summary* Summary = Field->Summary;
+		summaryblock* Block;
+		point Position;
+		blockcount* Count;
+		int level, finer;
+
+		for (level = TILE_SHIFT; level <= Summary->top; level++) {
+			Position.x = Point.x >> level;
+			Position.y = Point.y >> level;
+			if (!(Block = getSummaryBlock(Summary, level, Position, 1))) {
+				Summary->failed = 1;
+				return;
+			}
+			Block->shown += shown;
+			Block->flagged += flagged;
+			if (level != TILE_SHIFT) continue;
+			for (finer = 1; finer < TILE_SHIFT; finer++) {
+				Count = &Block->finer[finerIndex(finer, Point)];
+				Count->shown += shown;
+				Count->flagged += flagged;
+			}
+		}
+	}
+
+	void summaryCounts(field Field, int level, point Block, long long* shown, long long* flagged) {
+		summaryblock* Found;
+		minepoint* MinePoint;
+		point Position;
+		tile* Tile;
+
+		*shown = *flagged = 0;
+		if (level <= 0) {
+			/* A single square, which is hidden unless its tile has been made */
+			Position.x = Block.x >> TILE_SHIFT;
+			Position.y = Block.y >> TILE_SHIFT;
+			if (!(Tile = getTile(Field, Position, 0))) return;
+			MinePoint = &Tile->points[((Block.y & TILE_MASK) << TILE_SHIFT) | (Block.x & TILE_MASK)];
+			*shown = (getDisplay(*MinePoint) == DISPLAYED);
+			*flagged = (getDisplay(*MinePoint) == FLAGGED);
+			return;
+		}
+		if (level >= TILE_SHIFT) {
+			if (!(Found = getSummaryBlock(Field->Summary, level, Block, 0))) return;
+			*shown = Found->shown;
+			*flagged = Found->flagged;
+			return;
+		}
+		Position.x = Block.x >> (TILE_SHIFT - level);
+		Position.y = Block.y >> (TILE_SHIFT - level);
+		if (!(Found = getSummaryBlock(Field->Summary, TILE_SHIFT, Position, 0))) return;
+		Position.x = Block.x << level; // Any square in the block will do
+		Position.y = Block.y << level;
+		*shown = Found->finer[finerIndex(level, Position)].shown;
+		*flagged = Found->finer[finerIndex(level, Position)].flagged;
+	}
+
+	summaryblock* getSummaryBlock(summary* Summary, int level, point Position, int create) {
+		size_t mask = Summary->slots - 1;
+		summaryblock* Block;
+		size_t i;
+
+		for (i = summaryKey(level, Position) & mask; (Block = Summary->blocks[i]); i = (i+1) & mask) {
+			if (Block->level == level && Block->Block.x == Position.x && Block->Block.y == Position.y) return Block;
+		}
+		if (!create) return NULL;
+
+		if (!(Block = calloc(1, sizeof(summaryblock)))) return NULL;
+		Block->level = level;
+		Block->Block = Position;
+		if ((level == TILE_SHIFT && !(Block->finer = calloc(SUMMARY_FINER, sizeof(blockcount)))) || FAILED(addSummaryBlock(Summary, Block))) {
+			free(Block->finer);
+			free(Block);
+			return NULL;
+		}
+		return Block;
+	}
+
+	int addSummaryBlock(summary* Summary, summaryblock* Block) {
+		summaryblock** blocks;
+		size_t mask, i, j;
+
+		if ((Summary->count + 1) * 2 > Summary->slots) {
+			/* Keep the table at most half full, as the tiles' is */
+			if (!(blocks = calloc(Summary->slots * 2, sizeof(summaryblock*)))) return EXIT_FAILURE;
+			mask = Summary->slots * 2 - 1;
+			for (j=0; j<Summary->slots; j++) {
+				summaryblock* Old = Summary->blocks[j];
+				if (!Old) continue;
+				for (i = summaryKey(Old->level, Old->Block) & mask; blocks[i]; i = (i+1) & mask);
+				blocks[i] = Old;
+			}
+			free(Summary->blocks);
+			Summary->blocks = blocks;
+			Summary->slots *= 2;
+		}
+		mask = Summary->slots - 1;
+		for (i = summaryKey(Block->level, Block->Block) & mask; Summary->blocks[i]; i = (i+1) & mask);
+		Summary->blocks[i] = Block;
+		Summary->count++;
+		return EXIT_SUCCESS;
+	}
+
+	int finerIndex(int level, point Point) {
+		/* Each level's blocks are row-major, after all of the levels below it */
+		int side = TILE_SIZE >> level, base = 0, i;
+		for (i = 1; i < level; i++) base += (TILE_SIZE >> i) * (TILE_SIZE >> i);
+		return base + ((Point.y & TILE_MASK) >> level) * side + ((Point.x & TILE_MASK) >> level);
+	}
+
+	uint64_t summaryKey(int level, point Position) {
+		return mix64(((uint64_t) level << 56) ^ ((uint64_t) (unsigned int) Position.y << 28) ^ (unsigned int) Position.x);
+	}